@@ -0,0 +1,360 @@
+//
+//  Autotune.cpp
+//  GeneticAlgorithm
+//
+//  Created by Maxim Vainshtein on 19/10/2026.
+//  Copyright © 2026 Maxim Vainshtein. All rights reserved.
+//
+
+#include "Configuration.hpp"
+#include "GeneticAlgorithm.hpp"
+#include "Fitness.hpp"
+#include "Chromosome.hpp"
+#include "Utility.hpp"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <vector>
+#include <map>
+#include <memory>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <string>
+#include <stdexcept>
+#include <cstdio>
+
+///The values that are searched.
+static const size_t kPopulations[] = { 100, 200, 500, 1000, 2000, 5000 };
+static const float kCrossovers[] = { 0.5f, 0.7f, 0.9f, 1.0f };
+static const float kMutations[] = { 0.01f, 0.05f, 0.1f, 0.2f, 0.3f };
+static const Fitness::Type kTypes[] = { Fitness::kEditDistance, Fitness::kCloseness, Fitness::kColumnCarry };
+
+/**
+ * The settings of a tuning.
+ */
+struct Settings {
+    std::vector<std::string> corpus;
+    
+    ///Maximal number of seeds that a candidate runs every query with.
+    size_t trials;
+    
+    ///Number of runs at the same time.
+    size_t threads;
+    
+    ///Limit of generations of a run, 0 so that only the time limit stops it.
+    size_t generations;
+    
+    ///Seconds after which a run stops and counts as unsolved.
+    double limit;
+    
+    bool distinct;
+};
+
+/**
+ * A configuration with the times of its runs.
+ */
+struct Candidate {
+    Configuration configuration;
+    
+    ///Seconds to solution of every run, the limit for the unsolved ones.
+    std::vector<double> seconds;
+    
+    ///Number of seeds that every query was run with.
+    size_t trials;
+    
+    size_t solved;
+};
+
+/**
+ * Returns the value below which the fraction of the values are.
+ */
+double Percentile(std::vector<double> values, double fraction) {
+    
+    if (values.empty()) return 0;
+    
+    std::sort(values.begin(), values.end());
+    return values[std::min(values.size() - 1, static_cast<size_t>(fraction * values.size()))];
+}
+
+/**
+ * The objective that is minimised: the median and the tail of the time to solution count the same.
+ */
+double Cost(const Candidate& candidate) {
+    return Percentile(candidate.seconds, 0.5) + Percentile(candidate.seconds, 0.95);
+}
+
+/**
+ * Returns the seconds that the configuration takes to solve the query with the seed,
+ * the limit if it does not (or does not support the query).
+ */
+double TimeToSolution(const Configuration& configuration, const std::string& query, unsigned seed, const Settings& settings) {
+    
+    std::unique_ptr<Fitness> fitness;
+    
+    //The column carry fitness throws for queries that it does not support
+    try { fitness.reset(Fitness::CreateFitness(query, configuration.type)); }
+    catch (const std::invalid_argument&) { return settings.limit; }
+    
+    if (!fitness) return settings.limit;
+    
+    //Every random draw of the run is made by this thread
+    utility::Seed(seed);
+    
+    GeneticAlgorithm algorithm(configuration.population, configuration.crossover, configuration.mutation);
+    algorithm.SetVerbose(false);
+    algorithm.SetDistinctDigits(settings.distinct);
+    algorithm.SetTimeBudget(settings.limit);
+    
+    auto start = std::chrono::steady_clock::now();
+    Chromosome result = algorithm.FindSolution(*fitness, settings.generations);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    
+    if (fitness->Score(result) != fitness->OptimalScore()) return settings.limit;
+    
+    return std::min(elapsed.count(), settings.limit);
+}
+
+/**
+ * Runs every query of the corpus with the seeds that the candidates did not run yet,
+ * up to the number of trials, on the threads.
+ */
+void Evaluate(std::vector<Candidate>& candidates, size_t trials, const Settings& settings) {
+    
+    struct Run {
+        size_t candidate;
+        size_t query;
+        unsigned seed;
+        double seconds;
+    };
+    
+    std::vector<Run> runs;
+    for (size_t candidate = 0 ; candidate < candidates.size() ; candidate++)
+        for (size_t trial = candidates[candidate].trials ; trial < trials ; trial++)
+            for (size_t query = 0 ; query < settings.corpus.size() ; query++)
+                runs.push_back({ candidate, query, static_cast<unsigned>(trial + 1), 0 });
+    
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> workers;
+    
+    for (size_t worker = 0 ; worker < std::min(settings.threads, runs.size()) ; worker++) {
+        workers.push_back(std::thread([&]() {
+            
+            for (size_t index = next++ ; index < runs.size() ; index = next++) {
+                
+                Run& run = runs[index];
+                
+                try { run.seconds = TimeToSolution(candidates[run.candidate].configuration, settings.corpus[run.query], run.seed, settings); }
+                catch (...) { run.seconds = settings.limit; }
+            }
+        }));
+    }
+    
+    for (auto& worker : workers) worker.join();
+    
+    for (const auto& run : runs) {
+        
+        candidates[run.candidate].seconds.push_back(run.seconds);
+        if (run.seconds < settings.limit) candidates[run.candidate].solved++;
+    }
+    
+    for (auto& candidate : candidates) candidate.trials = std::max(candidate.trials, trials);
+}
+
+/**
+ * Returns every combination of the searched values.
+ */
+std::vector<Configuration> Grid() {
+    
+    std::vector<Configuration> configurations;
+    
+    for (auto population : kPopulations)
+        for (auto crossover : kCrossovers)
+            for (auto mutation : kMutations)
+                for (auto type : kTypes)
+                    configurations.push_back({ population, crossover, mutation, type });
+    
+    return configurations;
+}
+
+/**
+ * Returns distinct combinations of the searched values, drawn at random.
+ */
+std::vector<Configuration> Sample(size_t count) {
+    
+    std::vector<Configuration> grid = Grid();
+    
+    //A partial shuffle, the first ones are the sample
+    for (size_t index = 0 ; index < std::min(count, grid.size()) ; index++)
+        std::swap(grid[index], grid[index + utility::RandomInteger(static_cast<int>(grid.size() - index))]);
+    
+    grid.resize(std::min(count, grid.size()));
+    return grid;
+}
+
+/**
+ * Sorts the candidates from the best.
+ */
+void Rank(std::vector<Candidate>& candidates) {
+    
+    std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate& lhs, const Candidate& rhs) {
+        return Cost(lhs) < Cost(rhs);
+    });
+}
+
+/**
+ * Prints the configuration of the candidate with the statistics of its runs.
+ */
+void Print(const Candidate& candidate) {
+    
+    std::ostringstream name;
+    name << candidate.configuration;
+    
+    std::cout << std::left << std::setw(56) << name.str() << std::fixed << std::setprecision(1)
+    << "solved " << candidate.solved << "/" << candidate.seconds.size() << "\t"
+    << "median " << Percentile(candidate.seconds, 0.5) * 1000 << " ms\t"
+    << "p95 " << Percentile(candidate.seconds, 0.95) * 1000 << " ms\n";
+}
+
+/**
+ * Tunes by the strategy, returns the candidates from the best.
+ *
+ * grid and random run every candidate with all the trials. halving (successive halving)
+ * runs every candidate with a single trial, then keeps doubling the trials of the better
+ * half until a single candidate is left or the trials are used up, so that the runs go
+ * to the promising candidates.
+ */
+std::vector<Candidate> Tune(const std::string& strategy, size_t count, const Settings& settings) {
+    
+    std::vector<Configuration> configurations;
+    if (strategy == "grid") configurations = Grid();
+    else if (strategy == "random" || strategy == "halving") configurations = Sample(count);
+    else throw std::invalid_argument("Unknown strategy " + strategy + ", expected grid, random or halving");
+    
+    std::vector<Candidate> candidates;
+    for (const auto& configuration : configurations) candidates.push_back({ configuration, {}, 0, 0 });
+    
+    if (strategy != "halving") {
+        
+        Evaluate(candidates, settings.trials, settings);
+        Rank(candidates);
+        
+        return candidates;
+    }
+    
+    std::vector<Candidate> eliminated;
+    
+    for (size_t trials = 1 ; ; trials = std::min(trials * 2, settings.trials)) {
+        
+        Evaluate(candidates, trials, settings);
+        Rank(candidates);
+        
+        std::cout << candidates.size() << " candidates, " << trials << " trials: best ";
+        Print(candidates.front());
+        
+        if (candidates.size() == 1 || trials == settings.trials) break;
+        
+        //The worse half is out, it keeps its place after the survivors
+        size_t survivors = (candidates.size() + 1) / 2;
+        eliminated.insert(eliminated.begin(), candidates.begin() + survivors, candidates.end());
+        candidates.resize(survivors);
+    }
+    
+    candidates.insert(candidates.end(), eliminated.begin(), eliminated.end());
+    return candidates;
+}
+
+/**
+ * Reads the queries of a corpus file, one per line, skipping empty lines and comments.
+ */
+std::vector<std::string> ReadCorpus(const std::string& path) {
+    
+    std::ifstream file(path);
+    if (!file) throw std::runtime_error("Cannot read corpus " + path);
+    
+    std::vector<std::string> corpus;
+    std::string line;
+    
+    while (std::getline(file, line)) {
+        
+        line.erase(std::remove_if(line.begin(), line.end(), ::isspace), line.end());
+        if (!line.empty() && line.front() != '#') corpus.push_back(line);
+    }
+    
+    if (corpus.empty()) throw std::runtime_error("Corpus " + path + " has no queries");
+    
+    return corpus;
+}
+
+int main(int argc, const char * argv[]) {
+    
+    if (argc < 3) {
+        
+        std::cout
+        << "Tunes the configuration of the genetic algorithm over a corpus of queries:\n"
+        << "autotune <corpus file> <output configuration file> [strategy] [candidates] [trials] [threads] [limit] [distinct digits] [seed]\n"
+        << "Corpus: one query per line, # starts a comment.\n"
+        << "Strategy: grid, random or halving (default, successive halving).\n"
+        << "Candidates: number of configurations that random and halving draw (default 32).\n"
+        << "Trials: maximal number of seeds per query (default 4).\n"
+        << "Threads: number of runs at the same time (default all cores).\n"
+        << "Limit: milliseconds after which a run counts as unsolved (default 2000).\n"
+        << "Distinct digits: 1 to require a different digit per letter (default 0).\n"
+        << "Seed: of the draw of the candidates (default 1).\n"
+        << "The best configuration minimises the median plus the 95th percentile of the time to solution,\n"
+        << "and is written as the defaults of the configuration file (see genetic --config)."
+        << std::endl;
+        return 0;
+    }
+    
+    try {
+        
+        Settings settings;
+        settings.corpus = ReadCorpus(argv[1]);
+        settings.trials = (argc > 5) ? std::max(1, std::stoi(argv[5])) : 4;
+        settings.threads = (argc > 6 && std::stoi(argv[6]) > 0) ? std::stoi(argv[6]) : std::max(1u, std::thread::hardware_concurrency());
+        settings.generations = 0;
+        settings.limit = ((argc > 7) ? std::stod(argv[7]) : 2000) / 1000;
+        settings.distinct = (argc > 8) && std::stoi(argv[8]) != 0;
+        
+        std::string strategy = (argc > 3) ? argv[3] : "halving";
+        size_t count = (argc > 4) ? std::stoul(argv[4]) : 32;
+        
+        utility::Seed((argc > 9) ? std::stoul(argv[9]) : 1);
+        
+        std::cout << "Tuning over " << settings.corpus.size() << " queries with " << settings.threads << " threads\n";
+        
+        auto start = std::chrono::steady_clock::now();
+        std::vector<Candidate> candidates = Tune(strategy, count, settings);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        
+        std::cout << "Best candidates:\n";
+        for (size_t index = 0 ; index < std::min<size_t>(5, candidates.size()) ; index++) Print(candidates[index]);
+        
+        const Candidate& best = candidates.front();
+        
+        //The summary is kept as comments above the values
+        std::ofstream output(argv[2], std::ios::trunc);
+        if (!output) throw std::runtime_error(std::string("Cannot write ") + argv[2]);
+        
+        output << std::fixed << std::setprecision(1)
+        << "#Tuned by autotune (" << strategy << ") over " << settings.corpus.size() << " queries, " << best.trials << " trials"
+        << (settings.distinct ? ", distinct digits" : "") << ", in " << elapsed.count() << " s\n"
+        << "#Solved " << best.solved << "/" << best.seconds.size()
+        << ", median " << Percentile(best.seconds, 0.5) * 1000 << " ms, p95 " << Percentile(best.seconds, 0.95) * 1000 << " ms\n";
+        output.close();
+        
+        Configuration::Store(argv[2], "", best.configuration);
+        
+        std::cout << std::defaultfloat << "Wrote " << argv[2] << ": " << best.configuration << std::endl;
+    }
+    catch (const std::exception& error) {
+        
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
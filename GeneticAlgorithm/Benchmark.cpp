@@ -0,0 +1,510 @@
+//
+//  Benchmark.cpp
+//  GeneticAlgorithm
+//
+//  Created by Maxim Vainshtein on 19/10/2026.
+//  Copyright © 2026 Maxim Vainshtein. All rights reserved.
+//
+
+#include "Fitness.hpp"
+#include "EditDistanceFitness.hpp"
+#include "CompiledFitness.hpp"
+#include "Chromosome.hpp"
+#include "Utility.hpp"
+#include "GeneticAlgorithm.hpp"
+#include "Topology.hpp"
+#include "Portfolio.hpp"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <thread>
+#include <string>
+#include <sstream>
+#include <stdexcept>
+#include <sys/resource.h>
+
+static constexpr char kSendMoreMoney[] = "SEND+MORE=MONEY";
+static constexpr char kCrossRoadsDanger[] = "CROSS+ROADS=DANGER";
+static constexpr char kDivision[] = "ABCDEF/GH=IJK";
+
+/**
+ * Exposes the evaluation of the left hand side of a fitness.
+ */
+template <typename Base>
+class Evaluation : public Base {
+public:
+
+    using Base::Base;
+    using Base::Evaluate;
+};
+
+/**
+ * Returns the time per call of the function in nanoseconds.
+ */
+template <typename Function>
+double Measure(size_t calls, Function function) {
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t index = 0 ; index < calls ; index++) function(index);
+
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / calls;
+}
+
+/**
+ * Returns valid chromosomes of the fitness' query that it can score, as the search only
+ * keeps those (the others throw and are replaced).
+ */
+std::vector<Chromosome> ScorableChromosomes(const Fitness& fitness, size_t count) {
+    
+    std::string alphabet = utility::Alphabet(fitness.Query());
+    Chromosome::Constraints constraints = { fitness.NonZeroLetters(), alphabet.size() <= 10 };
+    
+    std::vector<Chromosome> chromosomes;
+    while (chromosomes.size() < count) {
+        
+        Chromosome chromosome(alphabet, constraints);
+        
+        try { fitness.Score(chromosome); }
+        catch (const std::runtime_error&) { continue; }
+        
+        chromosomes.push_back(chromosome);
+    }
+    
+    return chromosomes;
+}
+
+/**
+ * Compares the interpreted and the compiled evaluation and scoring of a query.
+ */
+template <const char* Query>
+void CompareCompiled(size_t calls) {
+
+    Evaluation<EditDistanceFitness> runtime(Query);
+    Evaluation<CompiledFitness<Query, EditDistanceFitness>> compiled;
+
+    //The same valid chromosomes for both
+    std::vector<Chromosome> chromosomes = ScorableChromosomes(runtime, 1024);
+
+    volatile long long sink = 0;
+
+    double runtime_evaluate = Measure(calls, [&](size_t index) { sink += runtime.Evaluate(chromosomes[index % 1024]); });
+    double compiled_evaluate = Measure(calls, [&](size_t index) { sink += compiled.Evaluate(chromosomes[index % 1024]); });
+    double runtime_score = Measure(calls, [&](size_t index) { sink += runtime.Score(chromosomes[index % 1024]); });
+    double compiled_score = Measure(calls, [&](size_t index) { sink += compiled.Score(chromosomes[index % 1024]); });
+
+    std::cout << std::left << std::setw(20) << Query << std::fixed << std::setprecision(1)
+    << "evaluate " << runtime_evaluate << " ns -> " << compiled_evaluate << " ns\t"
+    << "score " << runtime_score << " ns -> " << compiled_score << " ns\n";
+}
+
+/**
+ * Compares the interpreted and the generated evaluation and scoring of a query.
+ */
+void CompareGenerated(const std::string& query, size_t calls) {
+    
+    Evaluation<EditDistanceFitness> runtime(query);
+    Evaluation<EditDistanceFitness> generated(query);
+    
+    auto start = std::chrono::steady_clock::now();
+    bool available = generated.GenerateEvaluator();
+    std::chrono::duration<double, std::milli> generation = std::chrono::steady_clock::now() - start;
+    
+    if (!available) {
+        std::cout << std::left << std::setw(20) << query << "code generation is not available\n";
+        return;
+    }
+    
+    std::vector<Chromosome> chromosomes = ScorableChromosomes(runtime, 1024);
+    
+    volatile long long sink = 0;
+    
+    double runtime_evaluate = Measure(calls, [&](size_t index) { sink += runtime.Evaluate(chromosomes[index % 1024]); });
+    double generated_evaluate = Measure(calls, [&](size_t index) { sink += generated.Evaluate(chromosomes[index % 1024]); });
+    double runtime_score = Measure(calls, [&](size_t index) { sink += runtime.Score(chromosomes[index % 1024]); });
+    double generated_score = Measure(calls, [&](size_t index) { sink += generated.Score(chromosomes[index % 1024]); });
+    
+    std::cout << std::left << std::setw(20) << query << std::fixed << std::setprecision(1)
+    << "evaluate " << runtime_evaluate << " ns -> " << generated_evaluate << " ns\t"
+    << "score " << runtime_score << " ns -> " << generated_score << " ns\t"
+    << "generation " << generation.count() << " ms\n";
+}
+
+/**
+ * Returns the median of the values.
+ */
+double Median(std::vector<double> values) {
+    
+    if (values.empty()) return 0;
+    
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+/**
+ * Compares the generations and the time that each fitness type takes to solve the query,
+ * over the same seeds. Runs that reach the generation limit count with the limit.
+ */
+void CompareFitnessTypes(const std::string& query, size_t runs, size_t generations) {
+    
+    const std::pair<Fitness::Type, const char*> types[] = {
+        { Fitness::kEditDistance, "edit distance" },
+        { Fitness::kCloseness, "closeness" },
+        { Fitness::kColumnCarry, "column carry" }
+    };
+    
+    for (const auto& type : types) {
+        
+        std::vector<double> run_generations, run_milliseconds;
+        size_t solved = 0;
+        
+        for (size_t run = 0 ; run < runs ; run++) {
+            
+            std::srand(static_cast<unsigned>(run + 1));
+            utility::Seed(static_cast<unsigned>(run + 1));
+            
+            GeneticAlgorithm algorithm(200, 1, 0.1);
+            algorithm.SetVerbose(false);
+            algorithm.SetDistinctDigits(true);
+            
+            std::unique_ptr<Fitness> fitness(Fitness::CreateFitness(query, type.first));
+            
+            auto start = std::chrono::steady_clock::now();
+            Chromosome result = algorithm.FindSolution(*fitness, generations);
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            
+            if (fitness->Score(result) == fitness->OptimalScore()) solved++;
+            
+            run_generations.push_back(algorithm.Generations());
+            run_milliseconds.push_back(elapsed.count());
+        }
+        
+        std::cout << std::left << std::setw(22) << query << std::setw(15) << type.second << std::fixed << std::setprecision(1)
+        << "solved " << solved << "/" << runs << "\t"
+        << "median generations " << Median(run_generations) << "\t"
+        << "median time " << Median(run_milliseconds) << " ms\n";
+    }
+}
+
+/**
+ * Compares the uses of the necessary conditions of the query: the time per score and the
+ * fraction of scores that are short-circuited on random chromosomes, and the searches
+ * over the same seeds (the exact filter keeps the generations, the penalty changes them).
+ */
+void CompareFilters(const std::string& query, size_t calls, size_t runs, size_t generations) {
+    
+    const std::pair<Fitness::Filter, const char*> filters[] = {
+        { Fitness::kNoFilter, "none" },
+        { Fitness::kExactFilter, "exact" },
+        { Fitness::kPenaltyFilter, "penalty" }
+    };
+    
+    for (const auto& filter : filters) {
+        
+        std::unique_ptr<Fitness> fitness(Fitness::CreateFitness(query, Fitness::kEditDistance));
+        fitness->SetPreFilter(filter.first);
+        
+        Chromosome::Constraints constraints = { fitness->NonZeroLetters(), true };
+        std::vector<Chromosome> chromosomes;
+        for (size_t index = 0 ; index < 1024 ; index++)
+            chromosomes.push_back(Chromosome(utility::Alphabet(query), constraints));
+        
+        //Chromosomes that cannot be encoded throw, as they do in the search
+        volatile size_t sink = 0;
+        double score = Measure(calls, [&](size_t index) {
+            try { sink += fitness->Score(chromosomes[index % 1024]); }
+            catch (const std::runtime_error&) {}
+        });
+        double short_circuited = 100.0 * fitness->ShortCircuited() / fitness->Scored();
+        
+        std::vector<double> run_generations, run_milliseconds;
+        size_t solved = 0;
+        
+        for (size_t run = 0 ; run < runs ; run++) {
+            
+            std::srand(static_cast<unsigned>(run + 1));
+            utility::Seed(static_cast<unsigned>(run + 1));
+            
+            GeneticAlgorithm algorithm(200, 1, 0.1);
+            algorithm.SetVerbose(false);
+            algorithm.SetDistinctDigits(true);
+            
+            auto start = std::chrono::steady_clock::now();
+            Chromosome result = algorithm.FindSolution(*fitness, generations);
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            
+            if (fitness->Score(result) == fitness->OptimalScore()) solved++;
+            
+            run_generations.push_back(algorithm.Generations());
+            run_milliseconds.push_back(elapsed.count());
+        }
+        
+        std::cout << std::left << std::setw(22) << query << std::setw(9) << filter.second << std::fixed << std::setprecision(1)
+        << "score " << score << " ns	"
+        << "short-circuited " << short_circuited << "%	"
+        << "solved " << solved << "/" << runs << "	"
+        << "median generations " << Median(run_generations) << "	"
+        << "median time " << Median(run_milliseconds) << " ms\n";
+    }
+}
+
+/**
+ * Counts the random chromosomes whose score with the pre-filter differs from their score
+ * without it, where a chromosome that cannot be scored (throws) only matches another that
+ * cannot. The filters only save work, so there should be none.
+ */
+void CheckFilters(const std::string& query, size_t chromosomes) {
+    
+    std::unique_ptr<Fitness> unfiltered(Fitness::CreateFitness(query, Fitness::kEditDistance));
+    unfiltered->SetPreFilter(Fitness::kNoFilter);
+    
+    std::unique_ptr<Fitness> filtered(Fitness::CreateFitness(query, Fitness::kEditDistance));
+    filtered->SetPreFilter(Fitness::kExactFilter);
+    
+    //The score, or -1 if the chromosome cannot be scored
+    auto score = [](const Fitness& fitness, const Chromosome& chromosome) {
+        
+        try { return static_cast<long long>(fitness.Score(chromosome)); }
+        catch (const std::runtime_error&) { return -1LL; }
+    };
+    
+    std::string alphabet = utility::Alphabet(query);
+    size_t mismatches = 0;
+    
+    for (size_t index = 0 ; index < chromosomes ; index++) {
+        
+        Chromosome chromosome(alphabet);
+        if (score(*unfiltered, chromosome) != score(*filtered, chromosome)) mismatches++;
+    }
+    
+    std::cout << std::left << std::setw(22) << query << "mismatches " << mismatches << " of " << chromosomes
+    << "	short-circuited " << filtered->ShortCircuited() << "\n";
+}
+
+/**
+ * Returns the value below which the fraction of the values are.
+ */
+double Percentile(std::vector<double> values, double fraction) {
+    
+    if (values.empty()) return 0;
+    
+    std::sort(values.begin(), values.end());
+    return values[std::min(values.size() - 1, static_cast<size_t>(fraction * values.size()))];
+}
+
+/**
+ * Compares the time to solve the query of every default configuration of the portfolio
+ * alone with the race of all of them, over the same seeds. Runs that reach the generation
+ * limit count with their time.
+ */
+void CompareRacing(const std::string& query, size_t runs, size_t generations) {
+    
+    auto configurations = Portfolio::DefaultConfigurations();
+    
+    //Every configuration alone, then all of them
+    for (size_t entry = 0 ; entry <= configurations.size() ; entry++) {
+        
+        bool race = entry == configurations.size();
+        std::vector<Configuration> entrants = race ? configurations : std::vector<Configuration>{ configurations[entry] };
+        
+        Portfolio portfolio(entrants, 1);
+        portfolio.SetVerbose(false);
+        portfolio.SetDistinctDigits(true);
+        
+        std::vector<double> run_milliseconds;
+        size_t solved = 0;
+        bool supported = true;
+        
+        for (size_t run = 0 ; run < runs && supported ; run++) {
+            
+            std::srand(static_cast<unsigned>(run + 1));
+            
+            try { portfolio.Solve(query, generations); }
+            catch (const std::invalid_argument&) { supported = false; break; }
+            
+            if (portfolio.Solved()) solved++;
+            run_milliseconds.push_back(portfolio.Seconds() * 1000);
+        }
+        
+        if (!supported) continue;
+        
+        std::ostringstream name;
+        if (race) name << "race of " << configurations.size();
+        else name << configurations[entry];
+        
+        std::cout << std::left << std::setw(22) << query << std::setw(56) << name.str() << std::fixed << std::setprecision(1)
+        << "solved " << solved << "/" << runs << "\t"
+        << "median " << Median(run_milliseconds) << " ms\t"
+        << "p95 " << Percentile(run_milliseconds, 0.95) << " ms\n";
+    }
+}
+
+/**
+ * Compares the throughput of the island mode with and without NUMA placement. The
+ * query has no solution so every island runs all of its generations, and the population
+ * is large enough that the islands do not fit in the caches.
+ */
+void CompareIslandPlacement(size_t population, size_t generations, size_t runs) {
+    
+    auto nodes = topology::Nodes();
+    
+    size_t processors = 0;
+    for (const auto& node : nodes) processors += node.cpus.size();
+    
+    //At least two islands, so that migrations take place
+    size_t islands = std::max<size_t>(2, processors);
+    
+    std::cout << "Islands, " << nodes.size() << " nodes, " << processors << " processors ("
+    << islands << " islands, " << population << " members, " << generations << " generations, " << runs << " runs)\n";
+    
+    for (const bool placement : { false, true }) {
+        
+        std::vector<double> throughputs;
+        
+        for (size_t run = 0 ; run < runs ; run++) {
+            
+            std::srand(static_cast<unsigned>(run + 1));
+            
+            GeneticAlgorithm algorithm(population, 1, 0.1);
+            algorithm.SetVerbose(false);
+            algorithm.SetMode(GeneticAlgorithm::kIslands, islands);
+            algorithm.SetNumaPlacement(placement);
+            
+            auto start = std::chrono::steady_clock::now();
+            algorithm.FindSolution("ABCD+EFGH=IJKLMN", Fitness::kEditDistance, generations);
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            
+            throughputs.push_back(algorithm.Evaluations() / elapsed.count());
+        }
+        
+        std::cout << std::left << std::setw(22) << (placement ? "placed" : "not placed") << std::fixed << std::setprecision(0)
+        << "median " << Median(throughputs) << " evaluations per second\n";
+    }
+}
+
+/**
+ * Compares the throughput of the generations on a single thread and on the work stealing
+ * scheduler. Without distinct digits the chromosomes repeat digits, and the number of
+ * encodings (and so the cost of scoring) varies a lot between them.
+ */
+void CompareScheduling(const std::string& query, size_t population, size_t generations) {
+    
+    size_t threads = std::max(2u, std::thread::hardware_concurrency());
+    
+    std::cout << "Generation threads, " << query << " (" << population << " members, " << generations << " generations)\n";
+    
+    for (const size_t generation_threads : { size_t(1), threads }) {
+        
+        std::srand(1);
+        
+        GeneticAlgorithm algorithm(population, 1, 0.1);
+        algorithm.SetVerbose(false);
+        algorithm.SetGenerationThreads(generation_threads);
+        
+        auto start = std::chrono::steady_clock::now();
+        algorithm.FindSolution(query, Fitness::kEditDistance, generations);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        
+        auto scheduling = algorithm.Scheduling();
+        double total = scheduling.busy_seconds + scheduling.idle_seconds;
+        
+        std::cout << std::left << std::setw(22) << (std::to_string(generation_threads) + " threads") << std::fixed << std::setprecision(0)
+        << algorithm.Evaluations() / elapsed.count() << " evaluations per second\t"
+        << "tasks " << scheduling.tasks << "\t"
+        << "stolen " << scheduling.steals << "\t" << std::setprecision(1)
+        << "idle " << (total > 0 ? 100 * scheduling.idle_seconds / total : 0) << "%\n";
+    }
+}
+
+/**
+ * Returns the peak resident set size of the process in KB.
+ */
+long PeakResidentKilobytes() {
+    
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+/**
+ * Compares the throughput and the peak resident set size of the out of core and the in
+ * memory population. The peak only grows, so the out of core population goes first.
+ */
+void CompareOutOfCore(size_t population, size_t generations) {
+    
+    std::cout << "Out of core population (" << population << " members, " << generations << " generations)\n";
+    
+    for (const bool out_of_core : { true, false }) {
+        
+        std::srand(1);
+        
+        GeneticAlgorithm algorithm(population, 1, 0.1);
+        algorithm.SetVerbose(false);
+        if (out_of_core) algorithm.SetPopulationFile("benchmark.population");
+        
+        auto start = std::chrono::steady_clock::now();
+        algorithm.FindSolution("ABCD+EFGH=IJKLMN", Fitness::kEditDistance, generations);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        
+        std::cout << std::left << std::setw(22) << (out_of_core ? "mapped file" : "in memory") << std::fixed << std::setprecision(0)
+        << algorithm.Evaluations() / elapsed.count() << " evaluations per second\t"
+        << "peak resident set " << PeakResidentKilobytes() << " KB\n";
+    }
+}
+
+int main(int argc, const char * argv[]) {
+
+    std::srand(1);
+
+    size_t calls = (argc > 1) ? std::stoul(argv[1]) : 1000000;
+
+    std::cout << "Interpreted -> compiled fitness (" << calls << " calls)\n";
+    CompareCompiled<kSendMoreMoney>(calls);
+    CompareCompiled<kCrossRoadsDanger>(calls);
+    CompareCompiled<kDivision>(calls);
+    
+    std::cout << "Interpreted -> generated fitness (" << calls << " calls)\n";
+    CompareGenerated(kSendMoreMoney, calls);
+    CompareGenerated(kCrossRoadsDanger, calls);
+    CompareGenerated(kDivision, calls);
+    
+    size_t runs = (argc > 2) ? std::stoul(argv[2]) : 11;
+    
+    std::cout << "Fitness types, distinct digits (" << runs << " runs, up to 2000 generations)\n";
+    CompareFitnessTypes(kSendMoreMoney, runs, 2000);
+    CompareFitnessTypes("EAT+THAT=APPLE", runs, 2000);
+    CompareFitnessTypes("BASE+BALL=GAMES", runs, 2000);
+    CompareFitnessTypes("COUNT-COIN=SNUB", runs, 2000);
+    
+    std::cout << "Pre-filters, distinct digits (" << calls << " calls, " << runs << " runs, up to 2000 generations)\n";
+    CompareFilters(kSendMoreMoney, calls, runs, 2000);
+    CompareFilters(kCrossRoadsDanger, calls, runs, 2000);
+    CompareFilters("TWO*TWO=SQUARE", calls, runs, 2000);
+    
+    std::cout << "Exact pre-filter against none (100000 random chromosomes)\n";
+    CheckFilters(kSendMoreMoney, 100000);
+    CheckFilters(kCrossRoadsDanger, 100000);
+    CheckFilters("ABCD+EFGH=IJKLMN", 100000);
+    
+    std::cout << "Portfolio, distinct digits (" << runs << " runs, up to 2000 generations, one thread)\n";
+    CompareRacing(kSendMoreMoney, runs, 2000);
+    CompareRacing("DONALD+GERALD=ROBERT", runs, 2000);
+    CompareRacing("TWO*TWO=SQUARE", runs, 2000);
+    
+    CompareIslandPlacement(1000000, 3, 3);
+    
+    CompareScheduling("ABCD+EFGH=IJKLMN", 50000, 5);
+    
+    CompareOutOfCore(2000000, 3);
+
+    return 0;
+}
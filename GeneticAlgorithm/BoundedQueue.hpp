@@ -0,0 +1,137 @@
+//
+//  BoundedQueue.hpp
+//  GeneticAlgorithm
+//
+//  Created by Maxim Vainshtein on 19/10/2026.
+//  Copyright © 2026 Maxim Vainshtein. All rights reserved.
+//
+
+#ifndef BoundedQueue_hpp
+#define BoundedQueue_hpp
+#include <stdlib.h>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+/**
+ * A blocking first in first out queue with a fixed capacity, used to
+ * connect threads that produce and consume work at different rates.
+ */
+template <typename T>
+class BoundedQueue {
+public:
+    
+    /**
+     * Constructor.
+     *
+     * @param capacity  Maximal number of items that the queue holds.
+     */
+    BoundedQueue(size_t capacity) :
+    m_capacity(capacity ? capacity : 1),
+    m_closed(false)
+    { }
+    
+    /**
+     * Adds an item to the queue, blocks while the queue is full.
+     *
+     * @param item  The item to add.
+     * @return      False if the queue was closed and the item was dropped.
+     */
+    bool Push(T item) {
+        
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_not_full.wait(lock, [this]() { return m_closed || m_items.size() < m_capacity; });
+        
+        if (m_closed) return false;
+        
+        m_items.push_back(std::move(item));
+        m_not_empty.notify_one();
+        
+        return true;
+    }
+    
+    /**
+     * Adds an item to the queue if there is room for it, without blocking.
+     *
+     * @param item  The item to add.
+     * @return      False if the queue is full or was closed, and the item was not added.
+     */
+    bool TryPush(T item) {
+        
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_closed || m_items.size() >= m_capacity) return false;
+        
+        m_items.push_back(std::move(item));
+        m_not_empty.notify_one();
+        
+        return true;
+    }
+    
+    /**
+     * Removes the oldest item from the queue, blocks while the queue is empty.
+     *
+     * @param item  Receives the removed item.
+     * @return      False if the queue was closed and is empty.
+     */
+    bool Pop(T& item) {
+        
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_not_empty.wait(lock, [this]() { return m_closed || !m_items.empty(); });
+        
+        if (m_items.empty()) return false;
+        
+        item = std::move(m_items.front());
+        m_items.pop_front();
+        m_not_full.notify_one();
+        
+        return true;
+    }
+    
+    /**
+     * Removes the oldest item from the queue if there is one, without blocking.
+     *
+     * @param item  Receives the removed item.
+     * @return      False if the queue is empty.
+     */
+    bool TryPop(T& item) {
+        
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_items.empty()) return false;
+        
+        item = std::move(m_items.front());
+        m_items.pop_front();
+        m_not_full.notify_one();
+        
+        return true;
+    }
+    
+    /**
+     * Closes the queue, releasing all the threads that wait on it.
+     */
+    void Close() {
+        
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = true;
+        
+        m_not_full.notify_all();
+        m_not_empty.notify_all();
+    }
+    
+private:
+    
+    ///Stores the items in the order that they were pushed.
+    std::deque<T> m_items;
+    
+    ///Maximal number of items.
+    size_t m_capacity;
+    
+    ///True once the queue no longer accepts items.
+    bool m_closed;
+    
+    std::mutex m_mutex;
+    std::condition_variable m_not_full;
+    std::condition_variable m_not_empty;
+    
+};
+
+#endif /* BoundedQueue_hpp */
@@ -0,0 +1,21 @@
+//
+//  CancellationToken.cpp
+//  GeneticAlgorithm
+//
+//  Created by Maxim Vainshtein on 19/10/2026.
+//  Copyright © 2026 Maxim Vainshtein. All rights reserved.
+//
+
+#include "CancellationToken.hpp"
+
+CancellationToken::CancellationToken() :
+m_cancelled(std::make_shared<std::atomic<bool>>(false))
+{ }
+
+void CancellationToken::Cancel() {
+    m_cancelled->store(true, std::memory_order_relaxed);
+}
+
+bool CancellationToken::Cancelled() const {
+    return m_cancelled->load(std::memory_order_relaxed);
+}
@@ -0,0 +1,47 @@
+//
+//  CancellationToken.hpp
+//  GeneticAlgorithm
+//
+//  Created by Maxim Vainshtein on 19/10/2026.
+//  Copyright © 2026 Maxim Vainshtein. All rights reserved.
+//
+
+#ifndef CancellationToken_hpp
+#define CancellationToken_hpp
+#include <memory>
+#include <atomic>
+
+/**
+ * A flag that stops the searches that watch it. Copies of a token share their state,
+ * so a token can be handed to a GeneticAlgorithm (see SetCancellationToken) and
+ * cancelled later by another thread that holds a copy. A cancelled token stays
+ * cancelled.
+ */
+class CancellationToken {
+public:
+    
+    /**
+     * Constructor.
+     * Creates a token that is not cancelled.
+     */
+    CancellationToken();
+    
+    /**
+     * Cancels the token and every copy of it (thread safe).
+     */
+    void Cancel();
+    
+    /**
+     * Returns true if the token was cancelled (thread safe).
+     *
+     * @return  True if cancelled.
+     */
+    bool Cancelled() const;
+    
+private:
+    
+    std::shared_ptr<std::atomic<bool>> m_cancelled;
+    
+};
+
+#endif /* CancellationToken_hpp */
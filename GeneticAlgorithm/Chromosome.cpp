@@ -9,77 +9,355 @@
 #include "Chromosome.hpp"
 #include "Utility.hpp"
 #include <iterator>
+#include <algorithm>
 #include <tgmath.h>
 #include <vector>
 #include <string>
 #include <iostream>
+#include <stdexcept>
+#include <mutex>
+#include <memory>
 
-Chromosome Chromosome::Crossover(const Chromosome &first, const Chromosome &second, float point) {
+/**
+ * The letters of an alphabet, shared by its chromosomes.
+ */
+struct Chromosome::Letters {
     
-    elements crossed_over;
+    ///The letters in alphabetical order.
+    std::string letters;
+    size_t size;
     
-    //Insert first half
-    size_t first_half = point * first.m_interpretations.size();
+    ///Position of every character in the letters, -1 for characters that are not letters.
+    int index[256];
+};
+
+/**
+ * Returns the bits of the first letters of a packed chromosome.
+ */
+static uint64_t LowMask(size_t letters) {
+    return letters >= 16 ? ~0ULL : (1ULL << (4 * letters)) - 1;
+}
+
+/**
+ * Returns a bit per letter of the alphabet that is in the input.
+ */
+static uint32_t LetterMask(const std::string& input, const int* index) {
     
-    elements::const_iterator first_half_end = first.m_interpretations.begin();
-    std::advance(first_half_end, first_half);
+    uint32_t mask = 0;
+    for (const auto letter : input)
+        if (index[static_cast<unsigned char>(letter)] >= 0) mask |= 1u << index[static_cast<unsigned char>(letter)];
     
-    crossed_over.insert(first.m_interpretations.begin(), first_half_end);
+    return mask;
+}
 
-    //Insert second half
-    elements::const_iterator second_half_start = second.m_interpretations.begin();
-    std::advance(second_half_start, first_half);
+const Chromosome::Letters* Chromosome::Intern(const std::string& alphabet) {
+    
+    //Chromosomes of a search share an alphabet, so the last one is usually the one asked for
+    thread_local std::string last_alphabet;
+    thread_local const Letters* last_letters = NULL;
+    
+    if (last_letters && alphabet == last_alphabet) return last_letters;
+    
+    std::string sorted(alphabet);
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+    
+    //Never deallocated, chromosomes may outlive everything else
+    static std::mutex mutex;
+    static auto* interned = new std::map<std::string, std::unique_ptr<Letters>>();
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    std::unique_ptr<Letters>& letters = (*interned)[sorted];
+    if (!letters) {
+        
+        letters.reset(new Letters());
+        letters->letters = sorted;
+        letters->size = sorted.size();
+        std::fill(std::begin(letters->index), std::end(letters->index), -1);
+        
+        for (size_t index = 0 ; index < sorted.size() ; index++)
+            letters->index[static_cast<unsigned char>(sorted[index])] = static_cast<int>(index);
+    }
+    
+    last_alphabet = alphabet;
+    last_letters = letters.get();
+    
+    return last_letters;
+}
 
-    crossed_over.insert(second_half_start, second.m_interpretations.end());
+short Chromosome::At(size_t index) const {
+    return index < kPacked ? static_cast<short>((m_genome >> (4 * index)) & 0xF) : (*m_wide)[index - kPacked];
+}
 
-    return Chromosome(crossed_over);
+std::vector<short> Chromosome::Values() const {
+    
+    std::vector<short> values(m_letters->size);
+    for (size_t index = 0 ; index < values.size() ; index++) values[index] = At(index);
+    
+    return values;
 }
 
-Chromosome::Chromosome(const std::string& alphabet) {
+Chromosome Chromosome::Build(const Letters* letters, const std::vector<short>& values) {
     
-    for (auto begin = alphabet.begin(), end = alphabet.end() ;
-         begin != end ;
-         begin ++) {
+    uint64_t genome = 0;
+    for (size_t index = 0 ; index < std::min(kPacked, values.size()) ; index++)
+        genome |= static_cast<uint64_t>(values[index] & 0xF) << (4 * index);
+    
+    Chromosome chromosome(letters, genome);
+    if (values.size() > kPacked) chromosome.m_wide = std::make_shared<const std::vector<short>>(values.begin() + kPacked, values.end());
+    
+    return chromosome;
+}
 
+Chromosome Chromosome::Crossover(const Chromosome &first, const Chromosome &second, float point) {
+    
+    size_t split = static_cast<size_t>(point * first.m_letters->size);
+    
+    if (first.m_wide) {
+        
+        std::vector<short> values = second.Values();
+        for (size_t index = 0 ; index < split ; index++) values[index] = first.At(index);
         
-        m_interpretations.insert({{ *begin, std::rand() % 10 }});
+        return Build(first.m_letters, values);
     }
     
+    //The first letters are taken from the first chromosome and the rest from the second
+    uint64_t mask = LowMask(split);
+    
+    return Chromosome(first.m_letters, (first.m_genome & mask) | (second.m_genome & ~mask));
 }
 
-Chromosome::Chromosome(const elements& interpretations) :
-m_interpretations(interpretations)
+Chromosome::Chromosome(const Letters* letters, uint64_t genome) :
+m_genome(genome),
+m_letters(letters)
 { }
 
+Chromosome::Chromosome(const std::string& alphabet) :
+m_genome(0),
+m_letters(Intern(alphabet))
+{
+    if (m_letters->size > kPacked) {
+        
+        std::vector<short> values(m_letters->size);
+        for (auto& value : values) value = utility::RandomInteger(10);
+        
+        *this = Build(m_letters, values);
+        return;
+    }
+    
+    for (size_t index = 0 ; index < m_letters->size ; index++)
+        m_genome |= static_cast<uint64_t>(utility::RandomInteger(10)) << (4 * index);
+}
+
+Chromosome::Chromosome(const std::string& alphabet, const Constraints& constraints) :
+m_genome(0),
+m_letters(Intern(alphabet))
+{
+    if (constraints.distinct) {
+        
+        if (m_letters->size > 10)
+            throw std::invalid_argument("Chromosome cannot have distinct values for more than 10 letters.");
+        
+        //Draw distinct values by shuffling the digits
+        short digits[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+        for (int index = 9 ; index > 0 ; index--)
+            std::swap(digits[index], digits[utility::RandomInteger(index + 1)]);
+        
+        for (size_t index = 0 ; index < m_letters->size ; index++)
+            m_genome |= static_cast<uint64_t>(digits[index]) << (4 * index);
+    }
+    else if (m_letters->size > kPacked) {
+        
+        //Non zero letters draw from 1-9 directly
+        std::vector<short> values(m_letters->size);
+        for (size_t index = 0 ; index < values.size() ; index++) {
+            
+            bool non_zero = constraints.non_zero.find(m_letters->letters[index]) != std::string::npos;
+            values[index] = non_zero ? 1 + utility::RandomInteger(9) : utility::RandomInteger(10);
+        }
+        
+        *this = Build(m_letters, values);
+    }
+    else {
+        
+        //Non zero letters draw from 1-9 directly
+        uint32_t non_zero = LetterMask(constraints.non_zero, m_letters->index);
+        
+        for (size_t index = 0 ; index < m_letters->size ; index++) {
+            
+            uint64_t value = (non_zero & (1u << index)) ? 1 + utility::RandomInteger(9) : utility::RandomInteger(10);
+            m_genome |= value << (4 * index);
+        }
+    }
+    
+    //Only distinct values may still need a swap
+    *this = Repair(*this, constraints);
+}
+
+Chromosome::Chromosome(const elements& interpretations) :
+m_genome(0),
+m_letters(NULL)
+{
+    std::string alphabet;
+    for (const auto& interpretation : interpretations) alphabet.push_back(interpretation.first);
+    
+    //The map is in alphabetical order too
+    std::vector<short> values;
+    for (const auto& interpretation : interpretations) values.push_back(interpretation.second);
+    
+    *this = Build(Intern(alphabet), values);
+}
+
+Chromosome::Chromosome(const std::string& alphabet, uint64_t packed) :
+m_letters(Intern(alphabet))
+{
+    if (m_letters->size > kPacked)
+        throw std::length_error("Only chromosomes of up to 16 letters can be packed.");
+    
+    m_genome = packed & LowMask(m_letters->size);
+}
+
 Chromosome Chromosome::Mutate(const Chromosome& chromosome, float probability) {
     
-    elements mutated;
+    if (chromosome.m_wide) {
+        
+        //Mutate to a range of 0-9
+        std::vector<short> values = chromosome.Values();
+        for (auto& value : values)
+            if (utility::ThrowDice(probability)) value = utility::RandomInteger(10);
+        
+        return Build(chromosome.m_letters, values);
+    }
     
-    for (auto& interpretation : chromosome.m_interpretations) {
+    uint64_t genome = chromosome.m_genome;
+    
+    for (size_t index = 0 ; index < chromosome.m_letters->size ; index++) {
         
         //Mutate to a range of 0-9
-        mutated.insert({{ interpretation.first, (utility::ThrowDice(probability)) ? std::rand() % 10 : interpretation.second }});
+        if (utility::ThrowDice(probability)) {
+            
+            uint64_t shift = 4 * index;
+            genome = (genome & ~(0xFULL << shift)) | (static_cast<uint64_t>(utility::RandomInteger(10)) << shift);
+        }
     }
     
-    return Chromosome(mutated);
+    return Chromosome(chromosome.m_letters, genome);
+}
+
+Chromosome Chromosome::Mutate(const Chromosome& chromosome, uint64_t mask, uint64_t values) {
+    
+    mask &= LowMask(chromosome.m_letters->size);
+    
+    Chromosome mutated(chromosome);
+    mutated.m_genome = (chromosome.m_genome & ~mask) | (values & mask);
+    
+    return mutated;
+}
+
+Chromosome Chromosome::Repair(const Chromosome& chromosome, const Constraints& constraints) {
+    
+    if (chromosome.Satisfies(constraints)) return chromosome;
+    
+    const Letters& letters = *chromosome.m_letters;
+    
+    //Distinct values are limited to 10 letters, so only non zero letters are left to repair
+    if (chromosome.m_wide) {
+        
+        if (constraints.distinct)
+            throw std::invalid_argument("Chromosome cannot have distinct values for more than 10 letters.");
+        
+        std::vector<short> values = chromosome.Values();
+        for (size_t index = 0 ; index < values.size() ; index++)
+            if (values[index] == 0 && constraints.non_zero.find(letters.letters[index]) != std::string::npos)
+                values[index] = 1 + utility::RandomInteger(9);
+        
+        return Build(chromosome.m_letters, values);
+    }
+    
+    short repaired[16];
+    for (size_t index = 0 ; index < letters.size ; index++)
+        repaired[index] = (chromosome.m_genome >> (4 * index)) & 0xF;
+    
+    uint32_t non_zero_letters = LetterMask(constraints.non_zero, letters.index);
+    auto non_zero = [&](size_t index) { return (non_zero_letters & (1u << index)) != 0; };
+    
+    if (constraints.distinct) {
+        
+        if (letters.size > 10)
+            throw std::invalid_argument("Chromosome cannot have distinct values for more than 10 letters.");
+        
+        //Keep the first occurrence of each value and collect the letters that need a new one
+        bool used[16] = { false };
+        std::vector<size_t> conflicts;
+        for (size_t index = 0 ; index < letters.size ; index++) {
+            
+            if (used[repaired[index]] || (repaired[index] == 0 && non_zero(index)))
+                conflicts.push_back(index);
+            else
+                used[repaired[index]] = true;
+        }
+        
+        uint32_t pending = 0;
+        for (const auto index : conflicts) pending |= 1u << index;
+        
+        for (const auto letter : conflicts) {
+            
+            pending &= ~(1u << letter);
+            
+            //Pick a random unused value that the letter may take
+            std::vector<short> unused;
+            for (short value = non_zero(letter) ? 1 : 0 ; value < 10 ; value++)
+                if (!used[value]) unused.push_back(value);
+            
+            if (!unused.empty()) {
+                
+                short value = unused[utility::RandomInteger(static_cast<int>(unused.size()))];
+                repaired[letter] = value;
+                used[value] = true;
+                continue;
+            }
+            
+            //Only 0 is left, so hand it to a letter that can take it in exchange for its value
+            size_t swap = 0;
+            while (swap < letters.size && (non_zero(swap) || (pending & (1u << swap)) || repaired[swap] == 0)) swap++;
+            
+            if (swap == letters.size)
+                throw std::invalid_argument("Chromosome cannot satisfy the non zero letters with distinct values.");
+            
+            repaired[letter] = repaired[swap];
+            repaired[swap] = 0;
+            used[0] = true;
+        }
+    }
+    else {
+        
+        for (size_t index = 0 ; index < letters.size ; index++)
+            if (repaired[index] == 0 && non_zero(index))
+                repaired[index] = 1 + utility::RandomInteger(9);
+    }
+    
+    uint64_t genome = 0;
+    for (size_t index = 0 ; index < letters.size ; index++)
+        genome |= static_cast<uint64_t>(repaired[index]) << (4 * index);
+    
+    return Chromosome(chromosome.m_letters, genome);
 }
 
 size_t Chromosome::Decode(const std::string &input) const {
     
-    //Iterate over positions of characters and find corresponding values in map
+    //Iterate over the characters and find the corresponding values
     size_t result = 0;
-    size_t index = input.length() - 1;
-    for (std::string::const_iterator begin = input.begin(), end = input.end() ;
-         begin != end ;
-         begin ++, index--) {
+    for (const auto character : input) {
+        
+        int index = m_letters->index[static_cast<unsigned char>(character)];
         
-        auto search = m_interpretations.find(*begin);
-        if (search == m_interpretations.end()) {
+        if (index < 0) {
             
             //Throw exception to notify that the chromosome is invalid as it is missing a mapping to a required value
             throw std::runtime_error("Chromosome cannot decode value due to missing representations.");
         }
-        else result += std::pow(10, index) * search->second;
+        else result = result * 10 + At(index);
     }
     
     return result;
@@ -97,9 +375,9 @@ std::list<std::string> Chromosome::Encode(size_t value) const {
         //Find possible matches to the current letter
         std::vector<char> matches;
         bool found = false;
-        for (const auto& element : m_interpretations) {
-            if (element.second == (*begin - '0')) {
-                matches.push_back(element.first);
+        for (size_t index = 0 ; index < m_letters->size ; index++) {
+            if (At(index) == (*begin - '0')) {
+                matches.push_back(m_letters->letters[index]);
                 found = true;
             }
         }
@@ -131,14 +409,83 @@ std::list<std::string> Chromosome::Encode(size_t value) const {
     return results;
 }
 
+bool Chromosome::Encodes(size_t value) const {
+    
+    //A bit per digit that some letter has
+    int digits = 0;
+    for (size_t index = 0 ; index < m_letters->size ; index++) digits |= 1 << At(index);
+    
+    do {
+        
+        if (!(digits & (1 << (value % 10)))) return false;
+        value /= 10;
+    } while (value);
+    
+    return true;
+}
+
 short Chromosome::Value(char letter) const {
-    return m_interpretations.find(letter)->second;
+    
+    int index = m_letters->index[static_cast<unsigned char>(letter)];
+    return index < 0 ? -1 : At(index);
+}
+
+size_t Chromosome::Hash() const {
+    
+    //Each value fits in 4 bits, so the packing is exact
+    size_t hash = static_cast<size_t>(m_genome);
+    if (!m_wide) return hash;
+    
+    //Values past the packed letters are mixed in, which is no longer exact
+    for (const auto value : *m_wide) hash = hash * 31 + static_cast<size_t>(value);
+    
+    return hash;
+}
+
+uint64_t Chromosome::Pack() const {
+    
+    if (m_wide) throw std::length_error("Only chromosomes of up to 16 letters can be packed.");
+    
+    return m_genome;
+}
+
+bool Chromosome::Satisfies(const Constraints& constraints) const {
+    
+    for (const auto letter : constraints.non_zero) {
+        
+        int index = m_letters->index[static_cast<unsigned char>(letter)];
+        if (index >= 0 && At(index) == 0) return false;
+    }
+    
+    if (constraints.distinct) {
+        
+        int used = 0;
+        for (size_t index = 0 ; index < m_letters->size ; index++) {
+            
+            int value = At(index);
+            if (used & (1 << value)) return false;
+            used |= 1 << value;
+        }
+    }
+    
+    return true;
+}
+
+bool Chromosome::operator==(const Chromosome& other) const {
+    
+    //Letters are shared, so the same alphabet is the same pointer
+    return m_letters == other.m_letters && m_genome == other.m_genome &&
+           (m_wide == other.m_wide || (m_wide && other.m_wide && *m_wide == *other.m_wide));
+}
+
+bool Chromosome::operator!=(const Chromosome& other) const {
+    return !(*this == other);
 }
 
 std::ostream& operator<<(std::ostream& out, const Chromosome& chromosome) {
 
-    for (const auto& interpretation : chromosome.m_interpretations)
-        out << interpretation.first << "=" << interpretation.second << "\t";
+    for (size_t index = 0 ; index < chromosome.m_letters->size ; index++)
+        out << chromosome.m_letters->letters[index] << "=" << chromosome.At(index) << "\t";
 
     return out;
 }
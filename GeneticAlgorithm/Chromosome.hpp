@@ -11,12 +11,34 @@
 #include <map>
 #include <list>
 #include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
 
+/**
+ * Assigns a digit to every letter of an alphabet. The digits of the first 16 letters
+ * are packed 4 bits per letter in alphabetical order into a single word, and the letters
+ * are shared by all the chromosomes of the same alphabet, so a chromosome of up to 16
+ * letters is a few words and crossover, mutation, hashing and comparison are a handful
+ * of bit operations. The digits of any further letters are kept in a shared vector.
+ */
 class Chromosome {
 public:
 
     typedef std::map<char, short> elements;
     
+    /**
+     * Restrictions that the values of a valid chromosome satisfy.
+     */
+    struct Constraints {
+        
+        ///Letters that cannot be 0 (leading letters and divisors).
+        std::string non_zero;
+        
+        ///True if every letter must have a different value.
+        bool distinct;
+    };
+    
     /**
      * Crossover selects genes from parent chromosomes and creates a new offspring.
      *
@@ -38,6 +60,27 @@ public:
      */
     static Chromosome Mutate(const Chromosome& chromosome, float probability = 0.1);
     
+    /**
+     * Mutation with values that were drawn in advance, the letters are in alphabetical
+     * order 4 bits each (as in Pack). Only the first 16 letters can be mutated this way.
+     *
+     * @param chromosome    The chromosome to mutate.
+     * @param mask          Has all 4 bits set for each letter that is mutated.
+     * @param values        The new values of the mutated letters.
+     */
+    static Chromosome Mutate(const Chromosome& chromosome, uint64_t mask, uint64_t values);
+    
+    /**
+     * Repair changes the least values needed for the chromosome to satisfy the constraints.
+     * Letters that must be distinct keep the first value in alphabetical order, and letters
+     * that cannot be 0 get a random (unused, if distinct) value or swap with a letter that can.
+     *
+     * @param chromosome    The chromosome to repair.
+     * @param constraints   The constraints to satisfy.
+     * @return              The chromosome itself if it is valid, the repaired one otherwise.
+     */
+    static Chromosome Repair(const Chromosome& chromosome, const Constraints& constraints);
+    
     /**
      * Constructor.
      * Creates a chromosome with a random value per each letter.
@@ -46,26 +89,130 @@ public:
      */
     Chromosome(const std::string& alphabet);
     
+    /**
+     * Constructor.
+     * Creates a chromosome with random values per each letter that satisfy the constraints.
+     * Throws if the constraints cannot be satisfied.
+     *
+     * @param alphabet      The alphabet that the chromosome works on.
+     * @param constraints   The constraints that the values satisfy.
+     */
+    Chromosome(const std::string& alphabet, const Constraints& constraints);
+    
     /**
      * Constructor.
      * Creates a chromosome with specific values.
      */
     Chromosome(const elements& interpretations);
+    
+    /**
+     * Constructor.
+     * Creates a chromosome from values packed by Pack.
+     * Throws std::length_error if the alphabet has more than 16 letters.
+     *
+     * @param alphabet  The alphabet that the chromosome works on.
+     * @param packed    The packed values, 4 bits per letter in alphabetical order.
+     */
+    Chromosome(const std::string& alphabet, uint64_t packed);
 
     
     size_t Decode(const std::string& input) const;
     
     std::list<std::string> Encode(size_t value) const;
     
+    /**
+     * Checks if the value can be encoded, which is when every digit of it is the value
+     * of a letter (Encode throws otherwise).
+     *
+     * @param value The value to check.
+     * @return      True if Encode would succeed.
+     */
+    bool Encodes(size_t value) const;
+    
+    /**
+     * Returns the value of the letter, -1 if the chromosome has no such letter.
+     */
     short Value(char letter) const;
     
     std::string Representation(const std::string& representation) const;
     
+    /**
+     * Hashes the values of the chromosome. The values are packed 4 bits per letter,
+     * so distinct chromosomes over the same alphabet of up to 16 letters never share a
+     * hash; wider alphabets may.
+     *
+     * @return  The hash of the chromosome's values.
+     */
+    size_t Hash() const;
+    
+    /**
+     * Packs the values of the chromosome into 4 bits per letter in alphabetical order.
+     * Throws std::length_error if the alphabet has more than 16 letters.
+     *
+     * @return  The packed values.
+     */
+    uint64_t Pack() const;
+    
+    /**
+     * Checks if the chromosome satisfies the constraints.
+     *
+     * @param constraints   The constraints to check.
+     * @return              True if all the constraints are satisfied.
+     */
+    bool Satisfies(const Constraints& constraints) const;
+    
+    bool operator==(const Chromosome& other) const;
+    
+    bool operator!=(const Chromosome& other) const;
+    
     friend std::ostream& operator<<(std::ostream& out, const Chromosome& chromosome);
     
 private:
-        
-    elements m_interpretations;
+    
+    /**
+     * The letters of an alphabet, shared by its chromosomes.
+     */
+    struct Letters;
+    
+    /**
+     * Constructor.
+     *
+     * @param letters   The letters of the chromosome.
+     * @param genome    The packed values.
+     */
+    Chromosome(const Letters* letters, uint64_t genome);
+    
+    /**
+     * Returns the shared letters of the alphabet, sorted and unique.
+     */
+    static const Letters* Intern(const std::string& alphabet);
+    
+    /**
+     * Creates a chromosome with the values of the letters in alphabetical order.
+     */
+    static Chromosome Build(const Letters* letters, const std::vector<short>& values);
+    
+    /**
+     * Returns the value of the letter at the index in alphabetical order.
+     */
+    short At(size_t index) const;
+    
+    /**
+     * Returns the values of all the letters in alphabetical order.
+     */
+    std::vector<short> Values() const;
+    
+    ///The number of letters whose values are packed.
+    static const size_t kPacked = 16;
+    
+    ///The values of the first letters, 4 bits per letter in alphabetical order.
+    uint64_t m_genome;
+    
+    ///The letters, which are never deallocated.
+    const Letters* m_letters;
+    
+    ///The values of the letters past the packed ones, null if there are none.
+    std::shared_ptr<const std::vector<short>> m_wide;
     
 };
 #endif /* Chromosome_hpp */
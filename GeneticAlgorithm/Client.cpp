@@ -0,0 +1,179 @@
+//
+//  Client.cpp
+//  GeneticAlgorithm
+//
+//  Created by Maxim Vainshtein on 19/10/2026.
+//  Copyright © 2026 Maxim Vainshtein. All rights reserved.
+//
+
+#include "Protocol.hpp"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/**
+ * Connects to the server, throws std::runtime_error on failure.
+ */
+static int Connect(const std::string& path) {
+
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+    int connection = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (connection < 0 || connect(connection, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+
+        if (connection >= 0) close(connection);
+        throw std::runtime_error("Cannot connect to " + path);
+    }
+
+    return connection;
+}
+
+/**
+ * Sends a request and waits for its response.
+ */
+static std::string Request(int connection, const std::string& request) {
+
+    std::string response;
+
+    if (!protocol::WriteMessage(connection, request) || !protocol::ReadMessage(connection, response))
+        throw std::runtime_error("Connection closed by the server");
+
+    return response;
+}
+
+/**
+ * Returns the latency at the percentile of the sorted latencies.
+ */
+static double Percentile(const std::vector<double>& sorted, double percentile) {
+
+    if (sorted.empty()) return 0;
+
+    size_t index = static_cast<size_t>(percentile / 100 * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+/**
+ * Sends the request repeatedly from concurrent connections and prints the latencies.
+ */
+static void Benchmark(const std::string& path, const std::string& request, size_t requests, size_t concurrency) {
+
+    if (concurrency == 0) concurrency = 1;
+
+    std::vector<std::vector<double>> latencies(concurrency);
+    std::vector<size_t> solved(concurrency, 0);
+    std::vector<std::thread> clients;
+
+    //A connection per client, kept for all of its requests
+    std::vector<int> connections;
+    for (size_t client = 0 ; client < concurrency ; client++) connections.push_back(Connect(path));
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t client = 0 ; client < concurrency ; client++) {
+
+        clients.emplace_back([&, client]() {
+
+            int connection = connections[client];
+
+            for (size_t index = client ; index < requests ; index += concurrency) {
+
+                auto sent = std::chrono::steady_clock::now();
+
+                std::string response;
+                try { response = Request(connection, request); }
+                catch (...) { break; }
+
+                std::chrono::duration<double, std::milli> latency = std::chrono::steady_clock::now() - sent;
+
+                latencies[client].push_back(latency.count());
+                if (response.compare(0, 7, "solved ") == 0) solved[client]++;
+            }
+
+            close(connection);
+        });
+    }
+
+    for (std::thread& client : clients) client.join();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::vector<double> all;
+    size_t all_solved = 0;
+    for (size_t client = 0 ; client < concurrency ; client++) {
+        all.insert(all.end(), latencies[client].begin(), latencies[client].end());
+        all_solved += solved[client];
+    }
+
+    std::sort(all.begin(), all.end());
+
+    std::cout << std::fixed << std::setprecision(2)
+    << "Requests: " << all.size() << " (solved " << all_solved << ")\n"
+    << "Concurrency: " << concurrency << "\n"
+    << "Throughput: " << all.size() / elapsed.count() << " requests per second\n"
+    << "Latency p50: " << Percentile(all, 50) << " ms\n"
+    << "Latency p99: " << Percentile(all, 99) << " ms\n"
+    << "Latency max: " << (all.empty() ? 0 : all.back()) << " ms" << std::endl;
+}
+
+int main(int argc, const char * argv[]) {
+
+    //Help message for missing input
+    if (argc < 9) {
+
+        std::cout
+        << "Input the parameters in the following way:\n"
+        << "Path of the server socket (started with: genetic --serve <path>).\n"
+        << "Requested expression such as 'SEND+MORE=MONEY.\n"
+        << "Number of chromosomes (populations).\n"
+        << "Crossover probability (with range of 0...1).\n"
+        << "Mutation probability (with range of 0...1).\n"
+        << "Type of fitness function: 1 = Edit Distance. 2 = Closeness. 3 = Column carry (additions and subtractions).\n"
+        << "Number of generations (0 for no limit).\n"
+        << "Deadline in milliseconds (0 for no deadline).\n"
+        << "Benchmark: number of requests and concurrent connections (optional).\n"
+        << "For example: genetic-client /tmp/genetic.sock SEND+MORE=MONEY 200 1 0.1 1 0 1000 500 4"
+        << std::endl;
+        return 0;
+    }
+
+    try {
+
+        protocol::Request request;
+        request.query = argv[2];
+        request.population = std::stoul(argv[3]);
+        request.crossover = std::stof(argv[4]);
+        request.mutation = std::stof(argv[5]);
+        request.type = std::stoi(argv[6]);
+        request.generations = std::stoul(argv[7]);
+        request.deadline_ms = std::stoul(argv[8]);
+
+        if (argc > 9) {
+
+            Benchmark(argv[1], protocol::FormatRequest(request), std::stoul(argv[9]), (argc > 10) ? std::stoul(argv[10]) : 1);
+            return 0;
+        }
+
+        int connection = Connect(argv[1]);
+        std::cout << Request(connection, protocol::FormatRequest(request)) << std::endl;
+        close(connection);
+    }
+    catch (const std::exception& exception) {
+
+        std::cerr << exception.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,144 @@
+//
+//  ColumnCarryFitness.cpp
+//  GeneticAlgorithm
+//
+//  Created by Maxim Vainshtein on 19/10/2026.
+//  Copyright © 2026 Maxim Vainshtein. All rights reserved.
+//
+
+#include "ColumnCarryFitness.hpp"
+#include "Chromosome.hpp"
+#include "Utility.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+ColumnCarryFitness::ColumnCarryFitness(const std::string& query) :
+Fitness(query),
+m_alphabet(utility::Alphabet(query))
+{
+    const std::vector<std::string>& parameters = Parameters();
+    const std::vector<Operation>& operations = Operations();
+    const std::string& result = Result();
+
+    if (parameters.size() % 2)
+        throw std::invalid_argument("Column carry fitness needs the operands in pairs");
+
+    size_t length = result.length();
+    for (const auto& parameter : parameters) length = std::max(length, parameter.length());
+
+    m_columns.resize(length);
+
+    for (size_t index = 0 ; index < parameters.size() ; index++) {
+
+        //Operations are taken one per pair, as Fitness does: the second operand of a pair is subtracted on '-'
+        Operation operation = operations.at(index / 2);
+        if (operation != Operation::kAddition && operation != Operation::kSubtraction)
+            throw std::invalid_argument("Column carry fitness supports additions and subtractions only");
+
+        int sign = (index % 2 && operation == Operation::kSubtraction) ? -1 : 1;
+
+        const std::string& parameter = parameters[index];
+        for (size_t column = 0 ; column < parameter.length() ; column++)
+            m_columns[column].terms.push_back({ m_alphabet.find(parameter[parameter.length() - 1 - column]), sign });
+
+        if (parameter.length() > 1) m_leading.push_back(m_alphabet.find(parameter.front()));
+    }
+
+    for (size_t column = 0 ; column < length ; column++)
+        m_columns[column].result = (column < result.length()) ? static_cast<int>(m_alphabet.find(result[result.length() - 1 - column])) : -1;
+
+    if (result.length() > 1) m_leading.push_back(m_alphabet.find(result.front()));
+}
+
+///Number of steps of the difference between the sides, which break the ties of the columns.
+static const size_t kTiebreak = 200;
+
+size_t ColumnCarryFitness::ResolveChromosomeScore(const Chromosome& chromosome) const {
+
+    //The values of the letters by index, unpacked once (wider alphabets cannot be packed)
+    short packed_values[16];
+    std::vector<short> wide_values;
+    short* values = packed_values;
+    
+    if (m_alphabet.size() <= 16) {
+        
+        uint64_t packed = chromosome.Pack();
+        for (size_t letter = 0 ; letter < m_alphabet.size() ; letter++)
+            values[letter] = static_cast<short>((packed >> (4 * letter)) & 0xF);
+    }
+    else {
+        
+        wide_values.resize(m_alphabet.size());
+        values = wide_values.data();
+        
+        for (size_t letter = 0 ; letter < m_alphabet.size() ; letter++)
+            values[letter] = chromosome.Value(m_alphabet[letter]);
+    }
+
+    //Number starting with 0 is illigal
+    for (const auto letter : m_leading)
+        if (values[letter] == 0)
+            throw std::runtime_error("Chromosome contains illigal numbers placement that results with first character starting at 0");
+
+    size_t prefix = 0, satisfied = 0;
+    long long carry = 0, residual = 0, place = 1;
+
+    for (const auto& column : m_columns) {
+
+        long long sum = carry;
+        for (const auto& term : column.terms) sum += term.sign * values[term.letter];
+        if (column.result >= 0) sum -= values[column.result];
+
+        //The difference between the sides, column by column
+        residual += (sum - carry) * place;
+        place *= 10;
+
+        //Floor division, so that a borrow is a negative carry
+        long long remainder = ((sum % 10) + 10) % 10;
+        if (remainder == 0) {
+
+            satisfied++;
+            if (prefix == satisfied - 1) prefix++;
+        }
+
+        carry = (sum - remainder) / 10;
+    }
+
+    //The sides are equal
+    if (residual == 0) return ResolveOptimalScore(Result());
+
+    //A smaller difference breaks the ties, by its number of digits in steps of a tenth
+    double digits = std::log10(static_cast<double>(std::llabs(residual)));
+    size_t closeness = kTiebreak - 1 - std::min(kTiebreak - 1, static_cast<size_t>(digits * 10));
+
+    return (prefix * (m_columns.size() + 1) + satisfied) * kTiebreak + closeness;
+}
+
+size_t ColumnCarryFitness::ResolveScore(const std::string& estimated_result,
+                                        const std::string& real_result,
+                                        const Chromosome& chromosome) const {
+
+    if (estimated_result == real_result) return ResolveOptimalScore(real_result);
+
+    size_t prefix = 0, satisfied = 0;
+
+    //Matching columns from the least significant, weighted as in ResolveChromosomeScore
+    for (size_t column = 0 ; column < std::min(estimated_result.length(), real_result.length()) ; column++) {
+
+        if (estimated_result[estimated_result.length() - 1 - column] != real_result[real_result.length() - 1 - column]) continue;
+
+        satisfied++;
+        if (prefix == satisfied - 1) prefix++;
+    }
+
+    return (prefix * (m_columns.size() + 1) + satisfied) * kTiebreak;
+}
+
+size_t ColumnCarryFitness::ResolveOptimalScore(const std::string& result) const {
+    return (m_columns.size() + 1) * (m_columns.size() + 1) * kTiebreak;
+}
+
+bool ColumnCarryFitness::Descending() const { return false; }
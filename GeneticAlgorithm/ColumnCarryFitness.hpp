@@ -0,0 +1,104 @@
+//
+//  ColumnCarryFitness.hpp
+//  GeneticAlgorithm
+//
+//  Created by Maxim Vainshtein on 19/10/2026.
+//  Copyright © 2026 Maxim Vainshtein. All rights reserved.
+//
+
+#ifndef ColumnCarryFitness_hpp
+#define ColumnCarryFitness_hpp
+#include "Fitness.hpp"
+
+/**
+ * Works by checking the columns of the addition (or subtraction) the way it is done
+ * by hand: from the least significant column upward, each column sums the digits of
+ * the operands and the carry of the previous column, and is satisfied if the sum ends
+ * with the digit of the result. The score ranks the chromosomes by the run of satisfied
+ * columns from the least significant (their carries are right, so they stay satisfied
+ * whatever the higher columns become), then by the number of satisfied columns, and
+ * breaks the ties by the number of digits of the difference between the sides. The
+ * optimal score is only reached when the sides are equal.
+ *
+ * Supports queries whose operations are additions and subtractions only.
+ */
+class ColumnCarryFitness : public Fitness {
+public:
+
+    /**
+     * Constructor.
+     * Throws std::invalid_argument if the query has a multiplication or a division.
+     *
+     * @param query     The query that the fitness is based on.
+     */
+    ColumnCarryFitness(const std::string& query);
+
+    /**
+     * Returns true if the scores are based on descending or ascending order.
+     *
+     * @return True if descending (lower is better), false if ascending (higher is better).
+     */
+    virtual bool Descending() const;
+
+protected:
+
+    /**
+     * Scores the columns of the chromosome in a single pass.
+     * Throws if a number starts with 0.
+     *
+     * @param chromosome    The chromosome to calculate the score for.
+     * @return              The score, higher is better.
+     */
+    virtual size_t ResolveChromosomeScore(const Chromosome& chromosome) const;
+
+    /**
+     * Resolves the score between two strings by the matching columns, weighted as the
+     * columns of a chromosome are (without the difference between the sides).
+     *
+     * @param estimated_result      The result produced by the chromosome.
+     * @param real_result           The real result.
+     * @param chromosome            The chromosome that the score is calculated for.
+     * @return                      An estimation on how close the estimated result to the real result.
+     */
+    virtual size_t ResolveScore(const std::string& estimated_result, const std::string& real_result, const Chromosome& chromosome) const;
+
+    /**
+     * Resolves the best possible score for the real result.
+     *
+     * @param result        The final result that the chromosome is to match.
+     * @return              The best score.
+     */
+    virtual size_t ResolveOptimalScore(const std::string& result) const;
+
+private:
+
+    /**
+     * A letter of a column and the sign that its digit is added with.
+     */
+    struct Term {
+        size_t letter;
+        int sign;
+    };
+
+    /**
+     * The letters of a column.
+     */
+    struct Column {
+        std::vector<Term> terms;
+
+        ///Index of the letter of the result, -1 if the result is shorter.
+        int result;
+    };
+
+    ///The letters of the query in alphabetical order, as in Chromosome::Pack.
+    std::string m_alphabet;
+
+    ///The columns from the least significant.
+    std::vector<Column> m_columns;
+
+    ///Letters that start a multi letter number.
+    std::vector<size_t> m_leading;
+
+};
+
+#endif /* ColumnCarryFitness_hpp */
@@ -0,0 +1,239 @@
+//
+//  CompiledFitness.hpp
+//  GeneticAlgorithm
+//
+//  Created by Maxim Vainshtein on 19/10/2026.
+//  Copyright © 2026 Maxim Vainshtein. All rights reserved.
+//
+
+#ifndef CompiledFitness_hpp
+#define CompiledFitness_hpp
+#include <stdlib.h>
+#include <cstdint>
+#include <utility>
+#include <stdexcept>
+#include <initializer_list>
+#include "Fitness.hpp"
+#include "Chromosome.hpp"
+
+/**
+ * A query that was parsed at compile time. Every operand is reduced to a weight
+ * per letter (the letters are in alphabetical order, as in Chromosome::Pack), so
+ * its value is the sum of the weights multiplied by the values of the letters.
+ */
+struct CompiledQuery {
+
+    static constexpr size_t kMaxLetters = 16;
+    static constexpr size_t kMaxOperands = 16;
+
+    ///The letters of the query in alphabetical order.
+    char letters[kMaxLetters];
+    size_t letter_count;
+
+    ///Weight of each letter per operand.
+    long long weights[kMaxOperands][kMaxLetters];
+
+    ///Index of the leading letter of multi letter operands, -1 for single letter operands.
+    int leading[kMaxOperands];
+    size_t operand_count;
+
+    ///The operators in the order that they appear (the last is '=').
+    char operations[kMaxOperands];
+
+    ///False if the query has too many letters or operands.
+    bool valid;
+
+    constexpr CompiledQuery() :
+    letters{},
+    letter_count(0),
+    weights{},
+    leading{},
+    operand_count(0),
+    operations{},
+    valid(true)
+    { }
+
+    static constexpr bool IsOperator(char character) {
+        return character == '+' || character == '-' || character == '*' || character == '/' || character == '=';
+    }
+
+    constexpr int IndexOf(char letter) const {
+
+        for (size_t index = 0 ; index < letter_count ; index++)
+            if (letters[index] == letter) return static_cast<int>(index);
+
+        return -1;
+    }
+
+    /**
+     * Parses the query the same way that Fitness does.
+     *
+     * @param query     The query, such as "SEND+MORE=MONEY".
+     * @return          The parsed query.
+     */
+    static constexpr CompiledQuery Parse(const char* query) {
+
+        CompiledQuery parsed;
+
+        //Collect the letters in alphabetical order
+        for (const char* current = query ; *current ; current++) {
+
+            if (IsOperator(*current) || parsed.IndexOf(*current) >= 0) continue;
+
+            if (parsed.letter_count == kMaxLetters) {
+                parsed.valid = false;
+                return parsed;
+            }
+
+            size_t position = parsed.letter_count++;
+            while (position > 0 && parsed.letters[position - 1] > *current) {
+                parsed.letters[position] = parsed.letters[position - 1];
+                position--;
+            }
+            parsed.letters[position] = *current;
+        }
+
+        //Every segment that ends with an operator is an operand, the rest is the result
+        const char* start = query;
+        for (const char* current = query ; *current ; current++) {
+
+            if (!IsOperator(*current)) continue;
+
+            if (parsed.operand_count == kMaxOperands) {
+                parsed.valid = false;
+                return parsed;
+            }
+
+            size_t operand = parsed.operand_count++;
+            long long weight = 1;
+            for (const char* letter = current ; letter != start ; weight *= 10) {
+                letter--;
+                parsed.weights[operand][parsed.IndexOf(*letter)] += weight;
+            }
+
+            parsed.leading[operand] = (current - start > 1) ? parsed.IndexOf(*start) : -1;
+            parsed.operations[operand] = *current;
+
+            start = current + 1;
+        }
+
+        return parsed;
+    }
+};
+
+/**
+ * Evaluates the left hand side of a query that is known at compile time. The
+ * weights and operators are constants, so every operand is a fully unrolled
+ * sum over the packed values of the letters.
+ *
+ * The query must be a constexpr character array, as in:
+ *      static constexpr char kQuery[] = "SEND+MORE=MONEY";
+ *      CompiledEvaluator<kQuery>::Evaluate(chromosome.Pack());
+ */
+template <const char* Query>
+class CompiledEvaluator {
+public:
+
+    static constexpr CompiledQuery kParsed = CompiledQuery::Parse(Query);
+
+    static_assert(kParsed.valid, "The query has more letters or operands than a compiled query supports.");
+    static_assert(kParsed.operand_count % 2 == 0, "Operands of the query are evaluated in pairs.");
+
+    /**
+     * Calculates the value of the left hand side of the query.
+     * Throws if a number starts with 0 or a division is by 0.
+     *
+     * @param genome    The values of the letters, packed as in Chromosome::Pack.
+     * @return          The value of the left hand side.
+     */
+    static long long Evaluate(uint64_t genome) {
+        return EvaluatePairs(genome, std::make_index_sequence<kParsed.operand_count / 2>());
+    }
+
+private:
+
+    static long long Value(uint64_t genome, size_t letter) {
+        return static_cast<long long>((genome >> (4 * letter)) & 0xF);
+    }
+
+    template <size_t Operand, size_t... Letters>
+    static long long Decode(uint64_t genome, std::index_sequence<Letters...>) {
+
+        long long value = 0;
+        (void)std::initializer_list<int>{ (value += std::integral_constant<long long, kParsed.weights[Operand][Letters]>::value * Value(genome, Letters), 0)... };
+        return value;
+    }
+
+    template <size_t Operand>
+    static long long Decode(uint64_t genome) {
+
+        constexpr int leading = kParsed.leading[Operand];
+
+        //Number starting with 0 is illigal
+        if (leading >= 0 && Value(genome, leading) == 0)
+            throw std::runtime_error("Chromosome contains illigal numbers placement that results with first character starting at 0");
+
+        return Decode<Operand>(genome, std::make_index_sequence<kParsed.letter_count>());
+    }
+
+    template <size_t Pair>
+    static long long EvaluatePair(uint64_t genome) {
+
+        long long first = Decode<Pair * 2>(genome);
+        long long second = Decode<Pair * 2 + 1>(genome);
+
+        //Operations are taken one per pair, as Fitness does
+        switch (kParsed.operations[Pair]) {
+            case '*': return first * second;
+            case '/':
+
+                //Devision by 0 is illigal - possible for single length parameters
+                if (second == 0)
+                    throw std::runtime_error("Chromosome contains illigal numbers placement that results in devision by 0");
+
+                return first / second;
+            case '-': return first - second;
+            case '+': return first + second;
+            default: return 0;
+        }
+    }
+
+    template <size_t... Pairs>
+    static long long EvaluatePairs(uint64_t genome, std::index_sequence<Pairs...>) {
+
+        long long total = 0;
+        (void)std::initializer_list<int>{ (total += EvaluatePair<Pairs>(genome), 0)... };
+        return total;
+    }
+
+};
+
+template <const char* Query>
+constexpr CompiledQuery CompiledEvaluator<Query>::kParsed;
+
+/**
+ * A fitness of type Base (such as EditDistanceFitness) for a query that is known at
+ * compile time. The left hand side is evaluated by CompiledEvaluator instead of
+ * interpreting the parsed query, and the result is scored by Base as usual.
+ * It can be passed to GeneticAlgorithm::FindSolution in place of a created Fitness.
+ */
+template <const char* Query, typename Base>
+class CompiledFitness : public Base {
+public:
+
+    /**
+     * Constructor.
+     */
+    CompiledFitness() :
+    Base(Query)
+    { }
+
+protected:
+
+    virtual long long Evaluate(const Chromosome& chromosome) const {
+        return CompiledEvaluator<Query>::Evaluate(chromosome.Pack());
+    }
+
+};
+
+#endif /* CompiledFitness_hpp */
@@ -0,0 +1,217 @@
+//
+//  Configuration.cpp
+//  GeneticAlgorithm
+//
+//  Created by Maxim Vainshtein on 19/10/2026.
+//  Copyright © 2026 Maxim Vainshtein. All rights reserved.
+//
+
+#include "Configuration.hpp"
+#include <vector>
+#include <sstream>
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+
+static bool IsOperator(char character) {
+    return character == '+' || character == '-' || character == '*' || character == '/' || character == '=';
+}
+
+/**
+ * Removes the white space around a text.
+ */
+static std::string Trim(const std::string& text) {
+    
+    size_t begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) return std::string();
+    
+    return text.substr(begin, text.find_last_not_of(" \t\r") - begin + 1);
+}
+
+/**
+ * Returns the shape of a section header line, false if the line is not a header.
+ */
+static bool SectionOf(const std::string& line, std::string& shape) {
+    
+    std::string trimmed = Trim(line);
+    if (trimmed.size() < 2 || trimmed.front() != '[' || trimmed.back() != ']') return false;
+    
+    shape = trimmed.substr(1, trimmed.size() - 2);
+    return true;
+}
+
+/**
+ * Reads the whole file behind a descriptor.
+ */
+static std::string ReadAll(int file) {
+    
+    std::string contents;
+    char buffer[4096];
+    ssize_t length;
+    
+    lseek(file, 0, SEEK_SET);
+    while ((length = read(file, buffer, sizeof(buffer))) > 0) contents.append(buffer, length);
+    
+    return contents;
+}
+
+/**
+ * Applies a key=value line, returns false for comments and empty lines.
+ */
+static bool Apply(const std::string& line, Configuration& configuration) {
+    
+    std::string trimmed = Trim(line);
+    if (trimmed.empty() || trimmed.front() == '#') return false;
+    
+    size_t separator = trimmed.find('=');
+    if (separator == std::string::npos) throw std::runtime_error("Configuration line without a value: " + trimmed);
+    
+    std::string key = Trim(trimmed.substr(0, separator));
+    std::string value = Trim(trimmed.substr(separator + 1));
+    
+    try {
+        
+        if (key == "population")        configuration.population = std::stoul(value);
+        else if (key == "crossover")    configuration.crossover = std::stof(value);
+        else if (key == "mutation")     configuration.mutation = std::stof(value);
+        else if (key == "type")         configuration.type = static_cast<Fitness::Type>(std::stoi(value));
+        else throw std::runtime_error("Unknown configuration key: " + key);
+    }
+    catch (const std::logic_error&) {
+        throw std::runtime_error("Invalid configuration value: " + trimmed);
+    }
+    
+    return true;
+}
+
+std::string Configuration::Shape(const std::string& query) {
+    
+    std::string shape;
+    size_t length = 0;
+    
+    for (char character : query) {
+        
+        if (IsOperator(character)) {
+            
+            shape += std::to_string(length) + character;
+            length = 0;
+        }
+        else length++;
+    }
+    
+    return shape + std::to_string(length);
+}
+
+bool Configuration::Load(const std::string& path, const std::string& shape, Configuration& configuration) {
+    
+    int file = open(path.c_str(), O_RDONLY);
+    if (file < 0) return false;
+    
+    flock(file, LOCK_SH);
+    std::string contents = ReadAll(file);
+    flock(file, LOCK_UN);
+    close(file);
+    
+    Configuration loaded = configuration;
+    bool found = false;
+    
+    //The section of the shape is applied after the defaults, wherever it is in the file
+    std::vector<std::string> specific;
+    
+    std::istringstream lines(contents);
+    std::string line, section;
+    bool in_section = false;
+    
+    while (std::getline(lines, line)) {
+        
+        if (SectionOf(line, section)) in_section = true;
+        else if (!in_section) found |= Apply(line, loaded);
+        else if (!shape.empty() && section == shape) specific.push_back(line);
+    }
+    
+    for (const auto& value : specific) found |= Apply(value, loaded);
+    
+    if (found) configuration = loaded;
+    
+    return found;
+}
+
+void Configuration::Store(const std::string& path, const std::string& shape, const Configuration& configuration) {
+    
+    int file = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (file < 0)
+        throw std::runtime_error("Cannot open configuration " + path + ": " + std::strerror(errno));
+    
+    flock(file, LOCK_EX);
+    
+    std::ostringstream values;
+    values
+    << "population=" << configuration.population << '\n'
+    << "crossover=" << configuration.crossover << '\n'
+    << "mutation=" << configuration.mutation << '\n'
+    << "type=" << static_cast<int>(configuration.type) << '\n';
+    
+    //Split into the defaults and the sections, dropping the part that is replaced
+    std::istringstream lines(ReadAll(file));
+    std::string line, section, defaults, sections;
+    bool in_section = false, replaced = false;
+    
+    while (std::getline(lines, line)) {
+        
+        if (SectionOf(line, section)) {
+            
+            in_section = true;
+            replaced = !shape.empty() && section == shape;
+            
+            if (!replaced) sections += line + '\n';
+        }
+        else if (!in_section) {
+            
+            //Comments of the defaults are kept, their values are replaced
+            std::string trimmed = Trim(line);
+            if (!shape.empty() || trimmed.empty() || trimmed.front() == '#') defaults += line + '\n';
+        }
+        else if (!replaced) sections += line + '\n';
+    }
+    
+    std::vector<std::string> parts;
+    if (shape.empty()) parts = { defaults + values.str(), sections };
+    else parts = { defaults, sections, "[" + shape + "]\n" + values.str() };
+    
+    //A single empty line between the parts, however many times the file is rewritten
+    std::string contents;
+    for (auto& part : parts) {
+        
+        while (part.size() > 1 && part[part.size() - 1] == '\n' && part[part.size() - 2] == '\n') part.pop_back();
+        if (part.find_first_not_of(" \t\r\n") == std::string::npos) continue;
+        
+        contents += (contents.empty() ? "" : "\n") + part;
+    }
+    
+    bool written = ftruncate(file, 0) == 0 && pwrite(file, contents.data(), contents.size(), 0) == static_cast<ssize_t>(contents.size());
+    
+    flock(file, LOCK_UN);
+    close(file);
+    
+    if (!written) throw std::runtime_error("Cannot write configuration " + path);
+}
+
+std::ostream& operator<<(std::ostream& out, const Configuration& configuration) {
+    
+    return out
+    << "population=" << configuration.population
+    << " crossover=" << configuration.crossover
+    << " mutation=" << configuration.mutation
+    << " type=" << static_cast<int>(configuration.type);
+}
+
+bool operator==(const Configuration& lhs, const Configuration& rhs) {
+    
+    return lhs.population == rhs.population &&
+           lhs.crossover == rhs.crossover &&
+           lhs.mutation == rhs.mutation &&
+           lhs.type == rhs.type;
+}
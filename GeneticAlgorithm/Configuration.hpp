@@ -0,0 +1,93 @@
+//
+//  Configuration.hpp
+//  GeneticAlgorithm
+//
+//  Created by Maxim Vainshtein on 19/10/2026.
+//  Copyright © 2026 Maxim Vainshtein. All rights reserved.
+//
+
+#ifndef Configuration_hpp
+#define Configuration_hpp
+#include "Fitness.hpp"
+#include <stdlib.h>
+#include <string>
+#include <ostream>
+
+/**
+ * The parameters that a search is started with.
+ *
+ * Configurations are kept in a text file of key=value lines. The lines before the first
+ * section are the defaults, and a section starts with the shape of a query in brackets
+ * (see Shape), so that a query is configured by the section of its shape, else by the
+ * defaults:
+ *
+ *     #Comment
+ *     population=200
+ *     crossover=1
+ *     mutation=0.1
+ *     type=1
+ *
+ *     [4+4=5]
+ *     population=2000
+ *
+ * A section only overrides the keys that it has.
+ */
+struct Configuration {
+    
+    ///Number of chromosomes.
+    size_t population;
+    
+    ///Crossover and mutation probabilities (0...1).
+    float crossover;
+    float mutation;
+    
+    ///The fitness function.
+    Fitness::Type type;
+    
+    /**
+     * Returns the shape of a query: the letters of every number are replaced by the
+     * length of the number, so "SEND+MORE=MONEY" is "4+4=5". Queries of the same shape
+     * tend to be solved best by the same configuration.
+     *
+     * @param query     The query.
+     * @return          The shape of the query.
+     */
+    static std::string Shape(const std::string& query);
+    
+    /**
+     * Reads the configuration of a shape from a file, the defaults overridden by the
+     * section of the shape. Keys that are in neither keep their value.
+     * Throws std::runtime_error on an unknown key or an invalid value.
+     *
+     * @param path              Path of the file.
+     * @param shape             The shape of the query, empty for the defaults only.
+     * @param configuration     Receives the values that are found.
+     * @return                  False if the file cannot be read or has no values for the shape.
+     */
+    static bool Load(const std::string& path, const std::string& shape, Configuration& configuration);
+    
+    /**
+     * Writes the configuration of a shape to a file, replacing the section of the shape
+     * (or the defaults) and keeping the rest of the file. Processes that share the file
+     * are serialised by a lock.
+     * Throws std::runtime_error if the file cannot be written.
+     *
+     * @param path              Path of the file, created if needed.
+     * @param shape             The shape of the query, empty for the defaults.
+     * @param configuration     The configuration to write.
+     */
+    static void Store(const std::string& path, const std::string& shape, const Configuration& configuration);
+    
+};
+
+/**
+ * Prints the configuration as key=value pairs on a single line.
+ */
+std::ostream& operator<<(std::ostream& out, const Configuration& configuration);
+
+/**
+ * Returns true if the configurations have the same values.
+ */
+bool operator==(const Configuration& lhs, const Configuration& rhs);
+
+#endif /* Configuration_hpp */
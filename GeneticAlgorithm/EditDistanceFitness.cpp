@@ -47,4 +47,16 @@ size_t EditDistanceFitness::ResolveOptimalScore(const std::string &result) const
     return result.length();
 }
 
+bool EditDistanceFitness::ResolveLengthMismatchScore(size_t& score) const {
+    
+    score = 0;
+    return true;
+}
+
+bool EditDistanceFitness::ResolveInfeasibleScore(size_t& score) const {
+    
+    score = 0;
+    return true;
+}
+
 bool EditDistanceFitness::Descending() const { return false; }
\ No newline at end of file
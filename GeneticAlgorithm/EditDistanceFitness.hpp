@@ -51,5 +51,22 @@ protected:
      */
     virtual size_t ResolveOptimalScore(const std::string& result) const;
     
+    /**
+     * A result of a different length always scores 0.
+     *
+     * @param score     Receives 0.
+     * @return          True.
+     */
+    virtual bool ResolveLengthMismatchScore(size_t& score) const;
+    
+    /**
+     * Chromosomes that cannot be a solution are penalised with the score of a result
+     * of a different length.
+     *
+     * @param score     Receives 0.
+     * @return          True.
+     */
+    virtual bool ResolveInfeasibleScore(size_t& score) const;
+    
 };
 #endif /* EditDistanceFitness_hpp */
@@ -9,8 +9,37 @@
 #include "Fitness.hpp"
 #include "EditDistanceFitness.hpp"
 #include "ClosenessFitness.hpp"
+#include "ColumnCarryFitness.hpp"
 #include "Chromosome.hpp"
+#include "Utility.hpp"
+#include "GeneratedEvaluator.hpp"
+#include "PreFilter.hpp"
 #include <algorithm>
+#include <stdexcept>
+#include <atomic>
+
+///Number of counters of the scores, threads increment the counter of their index.
+static const size_t kCounterShards = 16;
+
+/**
+ * The counters of a shard, padded so that shards do not share a cache line.
+ */
+struct ScoreCounter {
+    std::atomic<size_t> scored;
+    std::atomic<size_t> short_circuited;
+    char padding[128 - 2 * sizeof(std::atomic<size_t>)];
+};
+
+/**
+ * Returns the counter shard of the calling thread, assigned round robin.
+ */
+static size_t CounterShard() {
+    
+    static std::atomic<size_t> next(0);
+    thread_local size_t shard = next++ % kCounterShards;
+    
+    return shard;
+}
 
 /**
  * Implementation.
@@ -34,12 +63,75 @@ public:
      */
     size_t Score(const Chromosome& chromosome) const;
     
+    /**
+     * Resolves the score by the necessary conditions of the query, if they can.
+     *
+     * @param chromosome    The chromosome to calculate the score for.
+     * @param score         Receives the score.
+     * @return              True if the score was resolved.
+     */
+    bool ShortCircuit(const Chromosome& chromosome, size_t& score) const;
+    
+    /**
+     * Sets the necessary conditions that resolve scores before they are calculated.
+     *
+     * @param filter    The filter to apply.
+     */
+    void SetPreFilter(Filter filter);
+    
+    /**
+     * Returns the number of chromosomes scored so far, across all the threads.
+     *
+     * @return  Number of scored chromosomes.
+     */
+    size_t Scored() const;
+    
+    /**
+     * Returns the number of scores that were resolved by the filter, across all the threads.
+     *
+     * @return  Number of short-circuited scores.
+     */
+    size_t ShortCircuited() const;
+    
+    /**
+     * Calculates the value of the left hand side of the query for the chromosome.
+     *
+     * @param chromosome    The chromosome that interprets the letters.
+     * @return              The value of the left hand side.
+     */
+    long long Evaluate(const Chromosome& chromosome) const;
+    
     /**
      * Calculates the optimal score for best possible chromosome.
      *
      * @return  Score of the perfect chromosome.
      */
     size_t OptimalScore() const;
+    
+    /**
+     * Returns the letters that cannot be 0 in a valid chromosome.
+     *
+     * @return  The non zero letters.
+     */
+    const std::string& NonZeroLetters() const;
+    
+    /**
+     * Returns the query that the fitness is based on.
+     *
+     * @return  The query.
+     */
+    const std::string& Query() const;
+    
+    /**
+     * Replaces the interpreted evaluation with generated code if possible.
+     *
+     * @return  True if the generated code is used.
+     */
+    bool GenerateEvaluator();
+    
+    const std::vector<std::string>& Parameters() const;
+    const std::vector<Operation>& Operations() const;
+    const std::string& Result() const;
 
 private:
     
@@ -54,6 +146,9 @@ private:
     ///Reference to the parent of the implementation.
     Fitness& m_parent;
     
+    ///Stores the query.
+    std::string m_query;
+    
     ///Contains all the operations that are to be made.
     std::vector<Operation> m_operations;
     
@@ -63,15 +158,37 @@ private:
     ///Stores the final result.
     std::string m_result;
     
+    ///Stores the letters that cannot be 0.
+    std::string m_non_zero;
+    
+    ///The generated evaluation of the query, if it is used.
+    std::shared_ptr<GeneratedEvaluator> m_generated;
+    
+    ///The necessary conditions of the query and how they are used.
+    std::unique_ptr<PreFilter> m_filter;
+    Filter m_filter_type;
+    
+    ///Counters of the scores.
+    mutable ScoreCounter m_counters[kCounterShards];
+    
 };
 
 #pragma mark - Implementation functions
 
 Fitness::Impl::Impl(const std::string& query, Fitness& parent) :
-m_parent(parent) {
+m_parent(parent),
+m_query(query),
+m_filter_type(Filter::kExactFilter) {
     
     //Populate the parameters and result strings
     Interpret(query);
+    
+    m_filter.reset(new PreFilter(m_parameters, std::vector<char>(m_operations.begin(), m_operations.end()), m_result, m_non_zero));
+    
+    for (auto& counter : m_counters) {
+        counter.scored = 0;
+        counter.short_circuited = 0;
+    }
 }
 
 void Fitness::Impl::Interpret(const std::string &query) {
@@ -103,12 +220,26 @@ void Fitness::Impl::Interpret(const std::string &query) {
             last_paramter_end = position + 1;
         }
     }
+    
+    //Numbers cannot start with 0
+    for (const auto& parameter : m_parameters)
+        if (parameter.length() > 1) m_non_zero.push_back(parameter.front());
+    
+    if (m_result.length() > 1) m_non_zero.push_back(m_result.front());
+    
+    //Single letter divisors cannot be 0 either
+    for (size_t index = 0 ; index + 1 < m_parameters.size() && index < m_operations.size() ; index++)
+        if (m_operations[index] == Operation::kDevision && !m_parameters[index + 1].empty()) m_non_zero.push_back(m_parameters[index + 1].front());
+    
+    m_non_zero = utility::Alphabet(m_non_zero);
 }
 
-size_t Fitness::Impl::Score(const Chromosome &chromosome) const {
+long long Fitness::Impl::Evaluate(const Chromosome &chromosome) const {
+    
+    if (m_generated) return m_generated->Evaluate(chromosome.Pack());
     
-    //First find the result using the chromosome's interpretation of the string
-    int total_value = 0;
+    //Find the result using the chromosome's interpretation of the string
+    long long total_value = 0;
     size_t operation_index = 0;
     for (std::vector<std::string>::const_iterator begin = m_parameters.begin(), end = m_parameters.end() ;
          begin != end ;
@@ -143,6 +274,17 @@ size_t Fitness::Impl::Score(const Chromosome &chromosome) const {
         }
     }
     
+    return total_value;
+}
+
+size_t Fitness::Impl::Score(const Chromosome &chromosome) const {
+    
+    //First find the result, the parent may provide a faster evaluation than the interpreted one
+    long long total_value = m_parent.Evaluate(chromosome);
+    
+    if (total_value < 0)
+        throw std::runtime_error("Chromosome results in a negative value that cannot be encoded");
+    
     //Get result string using the chromosome's interpreration
     std::list<std::string> estimated_results = chromosome.Encode(total_value);
     
@@ -156,8 +298,69 @@ size_t Fitness::Impl::Score(const Chromosome &chromosome) const {
     return static_cast<int>(*std::max_element(scores.begin(), scores.end()));
 }
 
+bool Fitness::Impl::ShortCircuit(const Chromosome& chromosome, size_t& score) const {
+    
+    ScoreCounter& counter = m_counters[CounterShard()];
+    counter.scored.fetch_add(1, std::memory_order_relaxed);
+    
+    if (m_filter_type == Filter::kNoFilter) return false;
+    
+    //Both are checked from a few letters, before the numbers are decoded and the value is encoded
+    bool resolved = (m_filter->LengthMismatch(chromosome) && m_parent.ResolveLengthMismatchScore(score)) ||
+                    (m_filter_type == Filter::kPenaltyFilter && !m_filter->Feasible(chromosome) && m_parent.ResolveInfeasibleScore(score));
+    
+    if (!resolved) return false;
+    
+    //A chromosome that cannot be scored is not given a score, as it would not be without the filter
+    try {
+        
+        long long total_value = m_parent.Evaluate(chromosome);
+        if (total_value < 0 || !chromosome.Encodes(static_cast<size_t>(total_value))) return false;
+    }
+    catch (const std::exception&) { return false; }
+    
+    counter.short_circuited.fetch_add(1, std::memory_order_relaxed);
+    
+    return true;
+}
+
+void Fitness::Impl::SetPreFilter(Filter filter) { m_filter_type = filter; }
+
+size_t Fitness::Impl::Scored() const {
+    
+    size_t total = 0;
+    for (const auto& counter : m_counters) total += counter.scored.load(std::memory_order_relaxed);
+    
+    return total;
+}
+
+size_t Fitness::Impl::ShortCircuited() const {
+    
+    size_t total = 0;
+    for (const auto& counter : m_counters) total += counter.short_circuited.load(std::memory_order_relaxed);
+    
+    return total;
+}
+
 size_t Fitness::Impl::OptimalScore() const { return m_parent.ResolveOptimalScore(m_result); }
 
+const std::string& Fitness::Impl::NonZeroLetters() const { return m_non_zero; }
+
+const std::string& Fitness::Impl::Query() const { return m_query; }
+
+const std::vector<std::string>& Fitness::Impl::Parameters() const { return m_parameters; }
+
+const std::vector<Fitness::Operation>& Fitness::Impl::Operations() const { return m_operations; }
+
+const std::string& Fitness::Impl::Result() const { return m_result; }
+
+bool Fitness::Impl::GenerateEvaluator() {
+    
+    //Falls back to the interpreter if there is no compiler
+    m_generated = GeneratedEvaluator::Create(m_query);
+    return m_generated != nullptr;
+}
+
 #pragma mark - Fitness functions
 
 Fitness* Fitness::CreateFitness(const std::string& query, Fitness::Type type) {
@@ -165,6 +368,8 @@ Fitness* Fitness::CreateFitness(const std::string& query, Fitness::Type type) {
     switch (type) {
         case Type::kEditDistance:   return new EditDistanceFitness(query);
         case Type::kCloseness:      return new ClosenessFitness(query);
+        case Type::kColumnCarry:    return new ColumnCarryFitness(query);
+        default:                    return NULL;
     }
 }
 
@@ -175,9 +380,65 @@ m_pimpl(new Impl(query, *this))
 Fitness::~Fitness() { }
 
 size_t Fitness::Score(const Chromosome &chromosome) const {
-    return m_pimpl->Score(chromosome);
+    
+    size_t score;
+    if (m_pimpl->ShortCircuit(chromosome, score)) return score;
+    
+    return ResolveChromosomeScore(chromosome);
 }
 
 size_t Fitness::OptimalScore() const {
     return m_pimpl->OptimalScore();
 }
+
+const std::string& Fitness::NonZeroLetters() const {
+    return m_pimpl->NonZeroLetters();
+}
+
+const std::string& Fitness::Query() const {
+    return m_pimpl->Query();
+}
+
+bool Fitness::GenerateEvaluator() {
+    return m_pimpl->GenerateEvaluator();
+}
+
+void Fitness::SetPreFilter(Filter filter) {
+    m_pimpl->SetPreFilter(filter);
+}
+
+size_t Fitness::Scored() const {
+    return m_pimpl->Scored();
+}
+
+size_t Fitness::ShortCircuited() const {
+    return m_pimpl->ShortCircuited();
+}
+
+long long Fitness::Evaluate(const Chromosome& chromosome) const {
+    return m_pimpl->Evaluate(chromosome);
+}
+
+size_t Fitness::ResolveChromosomeScore(const Chromosome& chromosome) const {
+    return m_pimpl->Score(chromosome);
+}
+
+const std::vector<std::string>& Fitness::Parameters() const {
+    return m_pimpl->Parameters();
+}
+
+const std::vector<Fitness::Operation>& Fitness::Operations() const {
+    return m_pimpl->Operations();
+}
+
+const std::string& Fitness::Result() const {
+    return m_pimpl->Result();
+}
+
+bool Fitness::ResolveLengthMismatchScore(size_t& score) const {
+    return false;
+}
+
+bool Fitness::ResolveInfeasibleScore(size_t& score) const {
+    return false;
+}
@@ -23,7 +23,24 @@ public:
      */
     enum Type {
         kEditDistance = 1,
-        kCloseness
+        kCloseness,
+        kColumnCarry
+    };
+    
+    /**
+     * How the cheap necessary conditions of the query (see PreFilter) are used before
+     * a chromosome is fully scored.
+     */
+    enum Filter {
+        
+        ///Every chromosome is fully scored.
+        kNoFilter = 0,
+        
+        ///Only chromosomes whose score the conditions determine are short-circuited, the scores do not change.
+        kExactFilter,
+        
+        ///Chromosomes that cannot be a solution also get the worst score, without their distance.
+        kPenaltyFilter
     };
     
     /**
@@ -50,6 +67,54 @@ public:
      */
     size_t OptimalScore() const;
     
+    /**
+     * Returns the letters that cannot be 0 in a valid chromosome: the leading letters
+     * of multi letter numbers and the divisors.
+     *
+     * @return  The non zero letters, sorted and unique.
+     */
+    const std::string& NonZeroLetters() const;
+    
+    /**
+     * Returns the query that the fitness is based on.
+     *
+     * @return  The query.
+     */
+    const std::string& Query() const;
+    
+    /**
+     * Replaces the interpreted evaluation of the query with straight line code that is
+     * generated for the query, compiled with the system compiler and loaded at runtime
+     * (see GeneratedEvaluator). If the code cannot be generated or compiled, the
+     * interpreter keeps being used.
+     *
+     * @return  True if the generated code is used, false if the interpreter is.
+     */
+    bool GenerateEvaluator();
+    
+    /**
+     * Sets how the necessary conditions of the query are used before scoring.
+     * The default is kExactFilter. Not thread safe with scoring.
+     *
+     * @param filter    The use of the conditions.
+     */
+    void SetPreFilter(Filter filter);
+    
+    /**
+     * Returns the number of chromosomes that were scored since the construction (thread safe).
+     *
+     * @return  Number of scores.
+     */
+    size_t Scored() const;
+    
+    /**
+     * Returns the number of scores that were resolved by the necessary conditions,
+     * without decoding and encoding the chromosome (thread safe).
+     *
+     * @return  Number of short-circuited scores.
+     */
+    size_t ShortCircuited() const;
+    
     /**
      * Returns true if the scores are based on descending or ascending order.
      *
@@ -82,6 +147,48 @@ protected:
      */
     Fitness(const std::string& query);
     
+    /**
+     * Calculates the value of the left hand side of the query for the chromosome.
+     * The default interprets the parsed query, subclasses may override it with a
+     * specialised evaluation of the same query. Throws if the chromosome places
+     * a 0 at the start of a number or divides by 0.
+     *
+     * @param chromosome    The chromosome that interprets the letters.
+     * @return              The value of the left hand side.
+     */
+    virtual long long Evaluate(const Chromosome& chromosome) const;
+    
+    /**
+     * Calculates the score of the chromosome. The default evaluates the left hand side,
+     * encodes the value with the chromosome and resolves the score of the encoding against
+     * the result. Subclasses may score the chromosome directly instead.
+     *
+     * @param chromosome    The chromosome to calculate the score for.
+     * @return              Score of input chromosome.
+     */
+    virtual size_t ResolveChromosomeScore(const Chromosome& chromosome) const;
+    
+    /**
+     * Returns the operands of the query in the order that they appear.
+     *
+     * @return  The operands.
+     */
+    const std::vector<std::string>& Parameters() const;
+    
+    /**
+     * Returns the operations of the query, one per pair of operands.
+     *
+     * @return  The operations.
+     */
+    const std::vector<Operation>& Operations() const;
+    
+    /**
+     * Returns the result of the query (the right hand side).
+     *
+     * @return  The result.
+     */
+    const std::string& Result() const;
+    
     /**
      * Resolves the score between two strings. The higher the score, the better then match.
      *
@@ -99,6 +206,24 @@ protected:
      * @return              The best score.
      */
     virtual size_t ResolveOptimalScore(const std::string& result) const = 0;
+    
+    /**
+     * Resolves the score of every chromosome whose left hand side has a different number
+     * of digits than the result, if they all have the same score. The default has none.
+     *
+     * @param score     Receives the score.
+     * @return          True if the score is known.
+     */
+    virtual bool ResolveLengthMismatchScore(size_t& score) const;
+    
+    /**
+     * Resolves the penalty of a chromosome that cannot be a solution, for kPenaltyFilter.
+     * The default has none, such chromosomes are fully scored.
+     *
+     * @param score     Receives the score.
+     * @return          True if there is a penalty.
+     */
+    virtual bool ResolveInfeasibleScore(size_t& score) const;
 
 private:
     
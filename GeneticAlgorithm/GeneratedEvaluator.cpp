@@ -0,0 +1,301 @@
+//
+//  GeneratedEvaluator.cpp
+//  GeneticAlgorithm
+//
+//  Created by Maxim Vainshtein on 19/10/2026.
+//  Copyright © 2026 Maxim Vainshtein. All rights reserved.
+//
+
+#include "GeneratedEvaluator.hpp"
+#include "CompiledFitness.hpp"
+#include <sstream>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+#include <cstdio>
+#include <cerrno>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+///Name of the generated function in the shared object.
+static const char* kFunctionName = "genetic_evaluate";
+
+/**
+ * Generates the source of the evaluation function of the parsed query.
+ */
+static std::string GenerateSource(const CompiledQuery& parsed) {
+
+    std::ostringstream source;
+
+    source
+    << "#include <stdint.h>\n"
+    << "extern \"C\" int " << kFunctionName << "(uint64_t genome, long long* total) {\n";
+
+    for (size_t letter = 0 ; letter < parsed.letter_count ; letter++)
+        source << "    const long long v" << letter << " = (genome >> " << letter * 4 << ") & 0xF;\n";
+
+    for (size_t operand = 0 ; operand < parsed.operand_count ; operand++) {
+
+        //Number starting with 0 is illigal
+        if (parsed.leading[operand] >= 0)
+            source << "    if (v" << parsed.leading[operand] << " == 0) return 1;\n";
+
+        source << "    const long long o" << operand << " = 0";
+        for (size_t letter = 0 ; letter < parsed.letter_count ; letter++)
+            if (parsed.weights[operand][letter])
+                source << " + " << parsed.weights[operand][letter] << "LL * v" << letter;
+        source << ";\n";
+    }
+
+    //Operations are taken one per pair, as Fitness does
+    source << "    long long result = 0;\n";
+    for (size_t pair = 0 ; pair < parsed.operand_count / 2 ; pair++) {
+
+        size_t first = pair * 2, second = pair * 2 + 1;
+        switch (parsed.operations[pair]) {
+            case '*': source << "    result += o" << first << " * o" << second << ";\n"; break;
+            case '/': source << "    if (o" << second << " == 0) return 2;\n"
+                             << "    result += o" << first << " / o" << second << ";\n"; break;
+            case '-': source << "    result += o" << first << " - o" << second << ";\n"; break;
+            case '+': source << "    result += o" << first << " + o" << second << ";\n"; break;
+            default: break;
+        }
+    }
+
+    source
+    << "    *total = result;\n"
+    << "    return 0;\n"
+    << "}\n";
+
+    return source.str();
+}
+
+/**
+ * Returns the directory of the shared objects of the current user, creating it if needed.
+ * Returns an empty string if it cannot be created, or if it is not a directory that only
+ * the user can access, as any shared object in it may be loaded.
+ */
+static std::string CacheDirectory() {
+
+    const char* base = getenv("GENETIC_CACHE_DIR");
+    if (!base) base = getenv("TMPDIR");
+    if (!base) base = "/tmp";
+
+    std::string directory = std::string(base) + "/genetic-" + std::to_string(geteuid());
+
+    if (mkdir(directory.c_str(), 0700) != 0 && errno != EEXIST) return std::string();
+
+    //Not followed if it is a link, an existing directory must already be private
+    struct stat status;
+    if (lstat(directory.c_str(), &status) != 0 ||
+        !S_ISDIR(status.st_mode) ||
+        status.st_uid != geteuid() ||
+        (status.st_mode & (S_IRWXG | S_IRWXO))) return std::string();
+
+    return directory;
+}
+
+/**
+ * Returns true if the file is a regular file that is owned by the current user, and
+ * that no one else can write to.
+ */
+static bool Trusted(const std::string& path) {
+
+    struct stat status;
+    return lstat(path.c_str(), &status) == 0 &&
+           S_ISREG(status.st_mode) &&
+           status.st_uid == geteuid() &&
+           !(status.st_mode & (S_IWGRP | S_IWOTH));
+}
+
+/**
+ * Runs the compiler on the source, without a shell. The compiler is taken from $CXX,
+ * whose words are passed as separate arguments, or c++.
+ *
+ * @return  True if the compiler succeeded.
+ */
+static bool RunCompiler(const std::string& source_path, const std::string& library) {
+
+    const char* compiler = getenv("CXX");
+
+    std::vector<std::string> words;
+    std::istringstream split(compiler ? compiler : "c++");
+    for (std::string word ; split >> word ; ) words.push_back(word);
+    if (words.empty()) words.push_back("c++");
+
+    for (const char* option : { "-O2", "-shared", "-fPIC", "-o" }) words.push_back(option);
+    words.push_back(library);
+    words.push_back(source_path);
+
+    //The arguments are built before the fork, the child only redirects and executes
+    std::vector<char*> arguments;
+    for (auto& word : words) arguments.push_back(&word[0]);
+    arguments.push_back(NULL);
+
+    pid_t child = fork();
+    if (child < 0) return false;
+
+    if (child == 0) {
+
+        int null = open("/dev/null", O_WRONLY);
+        if (null >= 0) {
+
+            dup2(null, STDOUT_FILENO);
+            dup2(null, STDERR_FILENO);
+        }
+
+        execvp(arguments[0], arguments.data());
+        _exit(127);
+    }
+
+    int status = 0;
+    while (waitpid(child, &status, 0) < 0) {
+        if (errno != EINTR) return false;
+    }
+
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+/**
+ * Returns true if the file is trusted (see Trusted) and holds exactly the source.
+ */
+static bool HoldsSource(const std::string& path, const std::string& source) {
+
+    if (!Trusted(path)) return false;
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return contents == source;
+}
+
+/**
+ * Returns the path of the shared object that is compiled from the source, compiling it
+ * if it is not cached. The source is kept next to the shared object, which is only taken
+ * from the cache if the source matches (the names are hashes, which may collide).
+ * Returns an empty string if the compilation failed.
+ *
+ * @param source    The source to compile.
+ * @param temporary Set to true if the shared object could not be cached, the caller removes it once it is loaded.
+ */
+static std::string CompileSource(const std::string& source, bool& temporary) {
+
+    temporary = false;
+
+    std::string directory = CacheDirectory();
+    if (directory.empty()) return std::string();
+
+    std::ostringstream name;
+    name << directory << "/genetic-" << std::hex << std::hash<std::string>()(source);
+
+    std::string library = name.str() + ".so";
+    std::string cached_source = name.str() + ".cpp";
+
+    //Cached by an earlier search (or process), the library is published after its source
+    if (HoldsSource(cached_source, source) && Trusted(library)) return library;
+
+    //Unique names so that concurrent processes (and searches) do not overwrite each other's files
+    static std::atomic<unsigned> counter(0);
+    name << "-" << std::dec << getpid() << "-" << counter++;
+    std::string source_path = name.str() + ".cpp";
+    std::string temporary_library = name.str() + ".so";
+
+    std::ofstream(source_path) << source;
+
+    if (!RunCompiler(source_path, temporary_library)) {
+
+        std::remove(source_path.c_str());
+        std::remove(temporary_library.c_str());
+        return std::string();
+    }
+
+    //Only the first to link its source publishes a library under the name, the rename makes it visible at once
+    bool published = link(source_path.c_str(), cached_source.c_str()) == 0 &&
+                     std::rename(temporary_library.c_str(), library.c_str()) == 0;
+
+    std::remove(source_path.c_str());
+
+    if (published) return library;
+
+    //Another source has the name, or is being published under it
+    temporary = true;
+    return temporary_library;
+}
+
+#pragma mark - GeneratedEvaluator functions
+
+std::shared_ptr<GeneratedEvaluator> GeneratedEvaluator::Create(const std::string& query) {
+
+    /**
+     * The evaluator of a query, locked while it is compiled.
+     */
+    struct Entry {
+        std::mutex mutex;
+        std::shared_ptr<GeneratedEvaluator> evaluator;
+    };
+
+    static std::mutex mutex;
+    static std::map<std::string, Entry> evaluators;
+
+    //Only the query is locked while it compiles, other queries compile at the same time
+    Entry* entry;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        entry = &evaluators[query];
+    }
+
+    std::lock_guard<std::mutex> lock(entry->mutex);
+    if (entry->evaluator) return entry->evaluator;
+
+    //Same restrictions as a compiled query, as the letters are taken from a packed genome
+    CompiledQuery parsed = CompiledQuery::Parse(query.c_str());
+    if (!parsed.valid || parsed.operand_count % 2 != 0) return entry->evaluator;
+
+    bool temporary = false;
+    std::string library = CompileSource(GenerateSource(parsed), temporary);
+
+    //Only a library that no one else could have replaced is loaded
+    void* handle = library.empty() || !Trusted(library) ? NULL : dlopen(library.c_str(), RTLD_NOW | RTLD_LOCAL);
+
+    //A loaded library stays mapped
+    if (temporary) std::remove(library.c_str());
+
+    if (handle) {
+
+        void* function = dlsym(handle, kFunctionName);
+        if (function) entry->evaluator.reset(new GeneratedEvaluator(handle, reinterpret_cast<evaluate_function>(function)));
+        else dlclose(handle);
+    }
+
+    //Failures are not kept, so a later search tries to compile again
+    return entry->evaluator;
+}
+
+GeneratedEvaluator::GeneratedEvaluator(void* handle, evaluate_function function) :
+m_handle(handle),
+m_function(function)
+{ }
+
+long long GeneratedEvaluator::Evaluate(uint64_t genome) const {
+
+    long long total = 0;
+
+    switch (m_function(genome, &total)) {
+        case 1: throw std::runtime_error("Chromosome contains illigal numbers placement that results with first character starting at 0");
+        case 2: throw std::runtime_error("Chromosome contains illigal numbers placement that results in devision by 0");
+    }
+
+    return total;
+}
+
+GeneratedEvaluator::~GeneratedEvaluator() {
+    dlclose(m_handle);
+}
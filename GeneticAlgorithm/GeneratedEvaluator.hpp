@@ -0,0 +1,75 @@
+//
+//  GeneratedEvaluator.hpp
+//  GeneticAlgorithm
+//
+//  Created by Maxim Vainshtein on 19/10/2026.
+//  Copyright © 2026 Maxim Vainshtein. All rights reserved.
+//
+
+#ifndef GeneratedEvaluator_hpp
+#define GeneratedEvaluator_hpp
+#include <stdlib.h>
+#include <cstdint>
+#include <string>
+#include <memory>
+
+/**
+ * Evaluates the left hand side of a query with straight line code that is generated
+ * for the query at runtime, compiled by the system compiler into a shared object and
+ * loaded with dlopen. The shared objects are cached on disk by the hash of their source,
+ * next to the source that they are only taken for, in a directory of the user that only
+ * the user can access (genetic-<uid> in $GENETIC_CACHE_DIR, or the temporary directory),
+ * and the loaded evaluators are cached in memory by query. A shared object is only loaded
+ * if it is owned by the user and no one else can write to it.
+ */
+class GeneratedEvaluator {
+public:
+
+    /**
+     * Factory function.
+     * Returns the evaluator of the query, generating and compiling it if needed.
+     * The compiler is taken from $CXX, or c++, and is run without a shell.
+     *
+     * @param query     The query to evaluate.
+     * @return          The evaluator, or NULL if the query is not supported or the compilation failed
+     *                  (which is tried again on the next call).
+     */
+    static std::shared_ptr<GeneratedEvaluator> Create(const std::string& query);
+
+    /**
+     * Calculates the value of the left hand side of the query.
+     * Throws if a number starts with 0 or a division is by 0.
+     *
+     * @param genome    The values of the letters, packed as in Chromosome::Pack.
+     * @return          The value of the left hand side.
+     */
+    long long Evaluate(uint64_t genome) const;
+
+    /**
+     * Destructor.
+     * Unloads the shared object.
+     */
+    ~GeneratedEvaluator();
+
+private:
+
+    /**
+     * Signature of the generated function, returns 0 on success, 1 for a number that
+     * starts with 0 and 2 for a division by 0.
+     */
+    typedef int (*evaluate_function)(uint64_t genome, long long* total);
+
+    /**
+     * Constructor.
+     *
+     * @param handle    The handle of the loaded shared object.
+     * @param function  The generated function in the shared object.
+     */
+    GeneratedEvaluator(void* handle, evaluate_function function);
+
+    void* m_handle;
+    evaluate_function m_function;
+
+};
+
+#endif /* GeneratedEvaluator_hpp */
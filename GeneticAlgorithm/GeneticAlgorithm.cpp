@@ -9,13 +9,40 @@
 #include "GeneticAlgorithm.hpp"
 #include "Fitness.hpp"
 #include "Utility.hpp"
+#include "OffspringPipeline.hpp"
+#include "SolutionCache.hpp"
+#include "SolutionSet.hpp"
+#include "Topology.hpp"
+#include "WorkStealingScheduler.hpp"
+#include "MappedPopulation.hpp"
 #include <vector>
 #include <iostream>
 #include <cmath>
 #include <algorithm>
+#include <unordered_map>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <mutex>
+#include <exception>
+#include <stdexcept>
 #include <stdlib.h>
+#include <sys/resource.h>
 
-size_t FindValidScoreOrReplace(const Fitness& fitness, Chromosome& chromosome, const std::string& alphabet) {
+///Number of members in a task of the work stealing scheduler.
+static const size_t kChunk = 32;
+
+///Number of members that the out of core population streams at a time (1 MiB).
+static const size_t kStreamChunk = 1 << 16;
+
+///Maximal number of members in the index of the best members of the out of core population.
+static const size_t kMaxElite = 1 << 16;
+
+size_t FindValidScoreOrReplace(const Fitness& fitness,
+                               Chromosome& chromosome,
+                               const std::string& alphabet,
+                               const Chromosome::Constraints& constraints,
+                               size_t& evaluations) {
     
     size_t score = 0;
 
@@ -23,11 +50,12 @@ size_t FindValidScoreOrReplace(const Fitness& fitness, Chromosome& chromosome, c
     while (!found_valid) {
         
         found_valid = true;
+        evaluations++;
         try { score = fitness.Score(chromosome); }
         catch (...) {
             
-            //The chromosome is invalid - replace it
-            chromosome = Chromosome(alphabet);
+            //The chromosome is invalid - replace it (constraints rule out leading zeros, not totals with a digit no letter has)
+            chromosome = Chromosome(alphabet, constraints);
             
             //Retry to find out if the replacement chromosome is valid
             found_valid = false;
@@ -61,8 +89,12 @@ public:
      *                                  without any change. If mutation is performed,
      *                                  part of chromosome is changed.
      *
+     * @param pipeline_depth            says how many batches of offspring can wait between the stages
+     *                                  of the offspring pipeline. If it is 0, offspring are bred and scored
+     *                                  one by one on the calling thread.
+     *
      */
-    Impl(size_t population_size, float crossover_probability, float mutation_probability);
+    Impl(size_t population_size, float crossover_probability, float mutation_probability, size_t pipeline_depth);
     
     /**
      * Finds the best solution to the query at the given number of generations.
@@ -72,9 +104,446 @@ public:
      * @param generations   Number of generations to perform.
      */
     Chromosome FindSolution(const std::string& query, Fitness::Type type, size_t generations);
+    
+    /**
+     * Finds the best solution to the fitness' query at the given number of generations.
+     *
+     * @param fitness       The fitness to use.
+     * @param generations   Number of generations to perform.
+     */
+    Chromosome FindSolution(const Fitness& fitness, size_t generations);
+    
+    /**
+     * Finds every distinct solution of the query.
+     *
+     * @param query         The query string.
+     * @param type          The type of fitness to use.
+     * @param generations   Number of generations to perform.
+     * @param max_solutions Number of solutions after which to stop.
+     * @param seconds       Time after which to stop.
+     */
+    std::vector<Chromosome> FindAllSolutions(const std::string& query, Fitness::Type type, size_t generations, size_t max_solutions, double seconds);
+    
+    /**
+     * Finds every distinct solution of the fitness' query.
+     *
+     * @param fitness       The fitness to use.
+     * @param generations   Number of generations to perform.
+     * @param max_solutions Number of solutions after which to stop.
+     * @param seconds       Time after which to stop.
+     */
+    std::vector<Chromosome> FindAllSolutions(const Fitness& fitness, size_t generations, size_t max_solutions, double seconds);
+    
+    /**
+     * Returns the seconds from the start of the last FindAllSolutions at which each of its
+     * solutions was found, filled once it returns.
+     *
+     * @return  The discovery time of each solution.
+     */
+    const std::vector<double>& DiscoveryTimes() const;
+    
+    /**
+     * Enables stagnation detection.
+     *
+     * @param window            Number of generations without improvement before a restart (0 disables).
+     * @param elite_fraction    Fraction of the population that survives a restart.
+     * @param strategy          The way the rest of the population is replaced.
+     */
+    void SetStagnation(size_t window, float elite_fraction, GeneticAlgorithm::Restart strategy);
+    
+    /**
+     * Returns the number of partial restarts performed by the last search.
+     *
+     * @return  Number of restarts.
+     */
+    size_t Restarts() const;
+    
+    /**
+     * Enables or disables the elimination of duplicate chromosomes.
+     *
+     * @param enabled   True to skip scoring of known chromosomes and replace duplicates.
+     */
+    void SetDeduplication(bool enabled);
+    
+    /**
+     * Returns the number of fitness evaluations performed by the last search.
+     *
+     * @return  Number of evaluations.
+     */
+    size_t Evaluations() const;
+    
+    /**
+     * Returns the number of generations performed by the last search.
+     *
+     * @return  Number of generations.
+     */
+    size_t Generations() const;
+    
+    /**
+     * Returns the number of fitness evaluations that were skipped by the last search
+     * since the chromosome was already scored.
+     *
+     * @return  Number of skipped evaluations.
+     */
+    size_t EvaluationsSaved() const;
+    
+    /**
+     * Returns the number of fitness evaluations of the last search that were resolved
+     * by the pre-filter.
+     *
+     * @return  Number of short-circuited evaluations.
+     */
+    size_t ShortCircuited() const;
+    
+    /**
+     * Sets the mode of the search.
+     *
+     * @param mode      The mode of the search.
+     * @param threads   Number of worker threads for the steady state mode (0 for all cores).
+     */
+    void SetMode(Mode mode, size_t threads);
+    
+    /**
+     * Sets the number of threads of every generation.
+     *
+     * @param threads   Number of threads, 0 for all cores.
+     */
+    void SetGenerationThreads(size_t threads);
+    
+    /**
+     * Returns the totals of the scheduler of the last search.
+     *
+     * @return  The totals of the scheduler.
+     */
+    WorkStealingScheduler::Statistics Scheduling() const;
+    
+    /**
+     * Sets how islands exchange members.
+     *
+     * @param interval  Generations between migrations, 0 isolates the islands.
+     * @param migrants  Number of members that are sent.
+     */
+    void SetMigration(size_t interval, size_t migrants);
+    
+    /**
+     * Sets whether the islands are placed on the NUMA nodes.
+     *
+     * @param enabled   True to place the islands.
+     */
+    void SetNumaPlacement(bool enabled);
+    
+    /**
+     * Sets whether every letter must have a different digit.
+     *
+     * @param distinct  True if digits must be distinct.
+     */
+    void SetDistinctDigits(bool distinct);
+    
+    /**
+     * Sets whether a scoring function is generated for the query.
+     *
+     * @param enabled   True to generate code.
+     */
+    void SetCodeGeneration(bool enabled);
+    
+    /**
+     * Sets the pre-filter of the fitness of every search.
+     *
+     * @param filter    The filter to apply.
+     */
+    void SetPreFilter(Fitness::Filter filter);
+    
+    /**
+     * Sets the file of the solution cache.
+     *
+     * @param path  Path of the cache file, empty disables the cache.
+     */
+    void SetSolutionCache(const std::string& path);
+    
+    /**
+     * Sets the file of the out of core population.
+     *
+     * @param path  Path of the file, empty keeps the population in memory.
+     */
+    void SetPopulationFile(const std::string& path);
+    
+    /**
+     * Stops the current search (thread safe).
+     */
+    void Cancel();
+    
+    /**
+     * Returns true if the last search was stopped by Cancel or by the token.
+     *
+     * @return  True if cancelled.
+     */
+    bool Cancelled() const;
+    
+    /**
+     * Sets the token that stops the searches.
+     *
+     * @param token     The token to watch.
+     */
+    void SetCancellationToken(const CancellationToken& token);
+    
+    /**
+     * Sets the wall clock budget of every search.
+     *
+     * @param seconds   Seconds that a search may take, 0 for no limit.
+     */
+    void SetTimeBudget(double seconds);
+    
+    /**
+     * Returns true if the last search was stopped by the time budget.
+     *
+     * @return  True if the time budget was spent.
+     */
+    bool TimedOut() const;
+    
+    /**
+     * Sets the function that is called when the best chromosome improves.
+     *
+     * @param progress  The function to call, empty to disable.
+     */
+    void SetProgressCallback(const GeneticAlgorithm::Progress& progress);
+    
+    /**
+     * Sets whether the statistics of the search are printed.
+     *
+     * @param verbose   True to print.
+     */
+    void SetVerbose(bool verbose);
 
 private:
     
+    /**
+     * Performs the search of FindSolution.
+     *
+     * @param fitness       The fitness to use.
+     * @param generations   Number of generations to perform.
+     */
+    Chromosome Search(const Fitness& fitness, size_t generations);
+    
+    /**
+     * A population member that is shared by the steady state workers. The score
+     * doubles as a lock: it is swapped to kBusySlot while the genome is written.
+     * Replacements only ever improve a slot's score, so a reader that sees the
+     * same score before and after reading the genome read a consistent member.
+     */
+    struct Slot {
+        std::atomic<uint64_t> score;
+        std::atomic<uint64_t> genome;
+    };
+    
+    ///Marks a slot whose genome is being replaced.
+    static const uint64_t kBusySlot = UINT64_MAX;
+    
+    /**
+     * Runs the steady state search on the scored population. Worker threads
+     * repeatedly breed a child from two tournament selected parents and replace
+     * a worse member with it, without any global synchronization.
+     *
+     * @param fitness       The fitness to use for score calculation.
+     * @param generations   Number of generations worth of evaluations to perform (0 for no limit).
+     * @return              The optimal chromosome, or the best one found.
+     */
+    Chromosome SteadyState(const Fitness& fitness, size_t generations);
+    
+    /**
+     * Performs the work of a single steady state thread.
+     *
+     * @param fitness       The fitness to use for score calculation.
+     * @param slots         The shared population.
+     * @param budget        Remaining number of evaluations (negative for no limit).
+     * @param found         Receives the packed optimal chromosome.
+     * @param solved        Set once a thread found an optimal chromosome.
+     * @param done          Set once the search should stop.
+     * @return              Number of evaluations performed by the thread.
+     */
+    size_t SteadyStateWorker(const Fitness& fitness,
+                             Slot* slots,
+                             std::atomic<long long>& budget,
+                             std::atomic<uint64_t>& found,
+                             std::atomic<bool>& solved,
+                             std::atomic<bool>& done);
+    
+    /**
+     * A member of an island.
+     */
+    struct Member {
+        uint64_t genome;
+        size_t score;
+    };
+    
+    /**
+     * The migrants that wait for an island, written by the previous island of the ring.
+     */
+    struct Inbox {
+        std::mutex mutex;
+        std::vector<Member> members;
+    };
+    
+    /**
+     * Runs the generational search on a population in the population file. Every
+     * generation streams over the members, and crossover partners are drawn from an
+     * index of the best members of the previous generation.
+     *
+     * @param fitness       The fitness to use for score calculation.
+     * @param generations   Number of generations to perform (0 for no limit).
+     * @return              The optimal chromosome, or the best one found.
+     */
+    Chromosome OutOfCore(const Fitness& fitness, size_t generations);
+    
+    /**
+     * Runs the island search. Every island thread creates, scores and breeds its own
+     * part of the population, and sends its best members to the next island every
+     * migration interval.
+     *
+     * @param fitness       The fitness to use for score calculation.
+     * @param generations   Number of generations of each island (0 for no limit).
+     * @return              The optimal chromosome, or the best one found.
+     */
+    Chromosome Islands(const Fitness& fitness, size_t generations);
+    
+    /**
+     * Performs the work of a single island.
+     *
+     * @param fitness       The fitness to use for score calculation.
+     * @param members       The members of the island, filled by the worker.
+     * @param size          Number of members.
+     * @param inbox         Migrants that arrive to the island.
+     * @param neighbour     Inbox of the next island.
+     * @param generations   Number of generations to perform (0 for no limit).
+     * @param found         Receives the packed optimal chromosome.
+     * @param solved        Set once an island found an optimal chromosome.
+     * @param done          Set once the search should stop.
+     * @param performed     Receives the number of generations performed.
+     * @return              Number of evaluations performed by the island.
+     */
+    size_t IslandWorker(const Fitness& fitness,
+                        Member* members,
+                        size_t size,
+                        Inbox& inbox,
+                        Inbox& neighbour,
+                        size_t generations,
+                        std::atomic<uint64_t>& found,
+                        std::atomic<bool>& solved,
+                        std::atomic<bool>& done,
+                        size_t& performed);
+    
+    /**
+     * Scores a chromosome produced by mutation or crossover. Chromosomes that are
+     * already known in the current generation are not scored.
+     *
+     * @param fitness       The fitness to use for score calculation.
+     * @param chromosome    The chromosome to score.
+     * @param score         Receives the score of the chromosome.
+     * @return              True if the chromosome is new and valid, false otherwise.
+     */
+    bool ScoreOffspring(const Fitness& fitness, const Chromosome& chromosome, size_t& score);
+    
+    /**
+     * Replaces chromosomes that are identical to a better chromosome in the (sorted)
+     * population with mutated or random ones, and sorts the population again.
+     *
+     * @param fitness   The fitness to use for score calculation.
+     */
+    void ReplaceDuplicates(const Fitness& fitness);
+    
+    /**
+     * Breeds the offspring of the sorted population, replacing each member with
+     * its offspring if they are better.
+     *
+     * @param fitness   The fitness to use for score calculation.
+     */
+    void BreedGeneration(const Fitness& fitness);
+    
+    /**
+     * Breeds the offspring of the sorted population through the offspring pipeline.
+     * Unlike BreedGeneration, all the offspring of a member are bred from the member
+     * as it was at the start of the generation.
+     *
+     * @param fitness   The fitness to use for score calculation.
+     * @param pipeline  The pipeline that breeds and scores the offspring.
+     */
+    void BreedGeneration(const Fitness& fitness, OffspringPipeline& pipeline);
+    
+    /**
+     * Breeds the offspring of the sorted population on the scheduler. Unlike BreedGeneration,
+     * crossover partners are taken as they were at the start of the generation, and
+     * duplicates are only detected against the scores known before the generation.
+     *
+     * @param fitness   The fitness to use for score calculation.
+     * @param scheduler The scheduler that runs the chunks of the population.
+     */
+    void BreedGeneration(const Fitness& fitness, WorkStealingScheduler& scheduler);
+    
+    /**
+     * Updates the scores of the chromosomes on the scheduler, see UpdateChromosomeScores.
+     *
+     * @param fitness   The fitness to use for score calculation.
+     * @param scheduler The scheduler that runs the chunks of the population.
+     * @return          The location to the optimal chromosome in member variables.
+     */
+    Chromosome* UpdateChromosomeScores(const Fitness& fitness, WorkStealingScheduler& scheduler);
+    
+    /**
+     * Prints the statistics of the search.
+     *
+     * @param generations   Number of generations performed.
+     */
+    void Report(size_t generations);
+    
+    /**
+     * Moves the optimal chromosomes of the population to the solutions, and
+     * replaces them with new valid chromosomes so the search goes on.
+     *
+     * @param fitness   The fitness that the scores are based on.
+     */
+    void CollectSolutions(const Fitness& fitness);
+    
+    /**
+     * Returns true if the solutions reached their number.
+     *
+     * @return  True if the enumeration should stop.
+     */
+    bool EnumerationDone() const;
+    
+    /**
+     * Returns true if the search was cancelled or its time budget is spent. Reads the
+     * clock if there is a time budget, so it is called once in a while.
+     *
+     * @return  True if the search should stop.
+     */
+    bool StopRequested() const;
+    
+    /**
+     * Passes the chromosome to the progress callback if its score is better than the
+     * best that was passed so far (thread safe).
+     *
+     * @param fitness       The fitness that the score is based on.
+     * @param chromosome    The best chromosome of the caller.
+     * @param score         The score of the chromosome.
+     */
+    void ReportProgress(const Fitness& fitness, const Chromosome& chromosome, size_t score);
+    
+    /**
+     * Checks if the sorted population improved its best or mean score since the last
+     * improvement, and performs a partial restart if it did not for the stagnation window.
+     *
+     * @param fitness   The fitness that the scores are based on.
+     */
+    void DetectStagnation(const Fitness& fitness);
+    
+    /**
+     * Keeps the elite chromosomes (the population must be sorted) and replaces
+     * the rest according to the restart strategy. The replacements are scored
+     * right away and the population is sorted again.
+     *
+     * @param fitness   The fitness that the scores are based on.
+     */
+    void PartialRestart(const Fitness& fitness);
+    
     /**
      * Updates the chromosomes that are contained in member variables using the input 
      * fitness object. The function iterates over all the chromosomes and updates it's
@@ -99,143 +568,1740 @@ private:
     float m_mutation_probability;
     
     std::string m_alphabet;
-};
-
-#pragma mark - Implementation functions
-
-GeneticAlgorithm::Impl::Impl(size_t population_size,
-                             float crossover_probability,
-                             float mutation_probability) :
-m_population_size(population_size),
-m_crossover_probability(crossover_probability),
-m_mutation_probability(mutation_probability)
-{ }
-
-Chromosome* GeneticAlgorithm::Impl::UpdateChromosomeScores(const Fitness& fitness) {
     
-    //Update Chromosomes so they contain valid chromosomes with scores
-    for (auto begin = m_chromosomes.begin(), end = m_chromosomes.end() ;
-         begin != end ;
-         begin++) {
-        
-        begin->second = FindValidScoreOrReplace(fitness, begin->first, m_alphabet);
-        
-        //Check for valid results
-        if (begin->second == fitness.OptimalScore())
-            return &begin->first;
-    }
+    ///Number of generations without improvement before a restart, 0 if disabled.
+    size_t m_stagnation_window;
     
-    //Didnt find answer
-    return NULL;
-}
-
-Chromosome GeneticAlgorithm::Impl::FindSolution(const std::string& query, Fitness::Type type, size_t generations) {
-
-    m_alphabet = utility::Alphabet(query);
+    ///Fraction of the population that survives a restart.
+    float m_elite_fraction;
     
-    /*
-     * The fitness can now estimate the score for
-     * chromosomes based on information parsed from
-     * the query (parameters and result strings).
-     */
-    std::unique_ptr<Fitness> fitness(Fitness::CreateFitness(query, type));
+    ///Stores the way the non elite chromosomes are replaced on restart.
+    GeneticAlgorithm::Restart m_restart_strategy;
     
-    //Create chromosomes with random values for each letter
-    for (size_t index = 0 ; index < m_population_size ; index++)
-        m_chromosomes.push_back(scored_chromosome(Chromosome(m_alphabet), 0));
+    ///Number of restarts performed during the current search.
+    size_t m_restarts;
     
-    //Ensuring that the number of counted generations is above 0 means that it will be equal and stop
-    size_t counted_generations = generations ? 0 : 1;
+    ///Number of consecutive generations without improvement.
+    size_t m_stagnant_generations;
     
-    while (true) {
-        
-        
-        Chromosome* result = UpdateChromosomeScores(*fitness);
-        
-        //In case a result was found return it
-        if (result) {
-            
-            std::cout << "Generations: " << counted_generations << '\n';
-            return *result;
-        }
-
-        //Sort so that the best chromosomes are the first
-        std::sort(m_chromosomes.begin(), m_chromosomes.end(), [&](scored_chromosome& lhs, scored_chromosome& rhs){
+    ///Best and mean scores at the last improvement.
+    size_t m_best_score;
+    double m_mean_score;
+    
+    ///True if the scores above need to be taken from the next generation.
+    bool m_scores_reset;
+    
+    ///True if known chromosomes are not scored again and duplicates are replaced (see SetDeduplication).
+    bool m_deduplication_enabled;
+    
+    ///True if the current search deduplicates, which needs a hash that identifies a chromosome.
+    bool m_deduplication;
+    
+    ///Scores of the chromosomes that were evaluated in the current generation, by hash.
+    std::unordered_map<size_t, size_t> m_known_scores;
+    
+    ///Number of fitness evaluations performed and skipped.
+    size_t m_evaluations;
+    size_t m_evaluations_saved;
+    
+    ///Stores the mode of the search.
+    GeneticAlgorithm::Mode m_mode;
+    
+    ///Number of worker threads for the steady state mode.
+    size_t m_threads;
+    
+    ///Number of threads of every generation, 0 for all cores.
+    size_t m_generation_threads;
+    
+    ///Runs the generations on several threads, kept between searches.
+    std::unique_ptr<WorkStealingScheduler> m_scheduler;
+    
+    ///True if the current search runs on the scheduler.
+    bool m_scheduled;
+    
+    ///Totals of the scheduler over the last search.
+    WorkStealingScheduler::Statistics m_scheduling;
+    
+    ///Generations between migrations of the islands, 0 if isolated.
+    size_t m_migration_interval;
+    
+    ///Number of members that an island sends on migration.
+    size_t m_migrants;
+    
+    ///True if the islands are pinned and allocated on their nodes.
+    bool m_numa_placement;
+    
+    ///Fitness evaluations per second of the last search.
+    double m_evaluations_per_second;
+    
+    ///Number of generations of the last search.
+    size_t m_generations;
+    
+    ///Time at which the current search started.
+    std::chrono::steady_clock::time_point m_start;
+    
+    ///Number of batches that can wait between the stages of the offspring pipeline, 0 if disabled.
+    size_t m_pipeline_depth;
+    
+    ///Constraints that all the chromosomes are created and repaired to satisfy.
+    Chromosome::Constraints m_constraints;
+    
+    ///True if a scoring function is generated for the query.
+    bool m_code_generation;
+    
+    ///The use of the necessary conditions by the fitness of a query.
+    Fitness::Filter m_pre_filter;
+    
+    ///The fitness of the current search, and its counters when the search started.
+    const Fitness* m_fitness;
+    size_t m_scored_start;
+    size_t m_short_circuited_start;
+    
+    ///Number of short-circuited evaluations of the last search.
+    size_t m_short_circuited;
+    
+    ///Path of the out of core population, empty if in memory.
+    std::string m_population_file;
+    
+    ///Solutions of earlier searches, NULL if disabled.
+    std::unique_ptr<SolutionCache> m_solution_cache;
+    
+    ///Set by Cancel to stop the current search.
+    std::atomic<bool> m_cancelled;
+    
+    ///True if the last search was cancelled.
+    bool m_was_cancelled;
+    
+    ///True if the statistics of the search are printed.
+    bool m_verbose;
+    
+    ///The solutions that are collected by FindAllSolutions, NULL when looking for a single one.
+    SolutionSet* m_solutions;
+    
+    ///Number of solutions after which the enumeration stops, 0 if unlimited.
+    size_t m_max_solutions;
+    
+    ///Seconds that the enumeration may take, 0 if unlimited.
+    double m_enumeration_seconds;
+    
+    ///Seconds that every search may take, 0 if unlimited.
+    double m_time_budget;
+    
+    ///Time at which the current search stops, if it has a time budget (of either kind).
+    std::chrono::steady_clock::time_point m_deadline;
+    bool m_has_deadline;
+    
+    ///True if the last search was stopped by the time budget.
+    bool m_timed_out;
+    
+    ///Stops the searches once cancelled, in addition to Cancel.
+    CancellationToken m_token;
+    
+    ///Called when the best chromosome improves, empty if disabled.
+    GeneticAlgorithm::Progress m_progress;
+    
+    ///Best score passed to the progress callback during the current search.
+    std::atomic<size_t> m_progress_score;
+    std::atomic<bool> m_progress_reported;
+    
+    ///Serializes the calls of the progress callback.
+    std::mutex m_progress_mutex;
+    
+    ///Discovery times of the solutions of the last enumeration.
+    std::vector<double> m_discovery_times;
+};
+
+#pragma mark - Implementation functions
+
+GeneticAlgorithm::Impl::Impl(size_t population_size,
+                             float crossover_probability,
+                             float mutation_probability,
+                             size_t pipeline_depth) :
+m_population_size(population_size),
+m_crossover_probability(crossover_probability),
+m_mutation_probability(mutation_probability),
+m_stagnation_window(0),
+m_elite_fraction(0.1),
+m_restart_strategy(GeneticAlgorithm::kReseed),
+m_restarts(0),
+m_stagnant_generations(0),
+m_best_score(0),
+m_mean_score(0),
+m_scores_reset(true),
+m_deduplication_enabled(true),
+m_deduplication(true),
+m_evaluations(0),
+m_evaluations_saved(0),
+m_mode(GeneticAlgorithm::kGenerational),
+m_threads(0),
+m_generation_threads(1),
+m_scheduled(false),
+m_scheduling({ 0, 0, 0, 0, 0 }),
+m_migration_interval(10),
+m_migrants(2),
+m_numa_placement(true),
+m_evaluations_per_second(0),
+m_generations(0),
+m_pipeline_depth(pipeline_depth),
+m_constraints({ "", false }),
+m_code_generation(false),
+m_pre_filter(Fitness::kExactFilter),
+m_fitness(NULL),
+m_scored_start(0),
+m_short_circuited_start(0),
+m_short_circuited(0),
+m_cancelled(false),
+m_was_cancelled(false),
+m_verbose(true),
+m_solutions(NULL),
+m_max_solutions(0),
+m_enumeration_seconds(0),
+m_time_budget(0),
+m_has_deadline(false),
+m_timed_out(false),
+m_progress_score(0),
+m_progress_reported(false)
+{ }
+
+void GeneticAlgorithm::Impl::Cancel() { m_cancelled = true; }
+
+bool GeneticAlgorithm::Impl::Cancelled() const { return m_was_cancelled; }
+
+void GeneticAlgorithm::Impl::SetCancellationToken(const CancellationToken& token) { m_token = token; }
+
+void GeneticAlgorithm::Impl::SetTimeBudget(double seconds) { m_time_budget = seconds; }
+
+bool GeneticAlgorithm::Impl::TimedOut() const { return m_timed_out; }
+
+void GeneticAlgorithm::Impl::SetProgressCallback(const GeneticAlgorithm::Progress& progress) { m_progress = progress; }
+
+void GeneticAlgorithm::Impl::SetVerbose(bool verbose) { m_verbose = verbose; }
+
+void GeneticAlgorithm::Impl::SetCodeGeneration(bool enabled) { m_code_generation = enabled; }
+
+void GeneticAlgorithm::Impl::SetPreFilter(Fitness::Filter filter) { m_pre_filter = filter; }
+
+void GeneticAlgorithm::Impl::SetSolutionCache(const std::string& path) {
+    m_solution_cache.reset(path.empty() ? NULL : new SolutionCache(path));
+}
+
+void GeneticAlgorithm::Impl::SetPopulationFile(const std::string& path) { m_population_file = path; }
+
+void GeneticAlgorithm::Impl::SetDistinctDigits(bool distinct) { m_constraints.distinct = distinct; }
+
+void GeneticAlgorithm::Impl::SetMode(GeneticAlgorithm::Mode mode, size_t threads) {
+    
+    m_mode = mode;
+    m_threads = threads;
+}
+
+void GeneticAlgorithm::Impl::SetMigration(size_t interval, size_t migrants) {
+    
+    m_migration_interval = interval;
+    m_migrants = migrants;
+}
+
+void GeneticAlgorithm::Impl::SetNumaPlacement(bool enabled) { m_numa_placement = enabled; }
+
+void GeneticAlgorithm::Impl::SetGenerationThreads(size_t threads) { m_generation_threads = threads; }
+
+WorkStealingScheduler::Statistics GeneticAlgorithm::Impl::Scheduling() const { return m_scheduling; }
+
+size_t GeneticAlgorithm::Impl::SteadyStateWorker(const Fitness& fitness,
+                                                 Slot* slots,
+                                                 std::atomic<long long>& budget,
+                                                 std::atomic<uint64_t>& found,
+                                                 std::atomic<bool>& solved,
+                                                 std::atomic<bool>& done) {
+    
+    const int population = static_cast<int>(m_population_size);
+    const bool descending = fitness.Descending();
+    const size_t optimal_score = fitness.OptimalScore();
+    
+    auto better = [descending](uint64_t lhs, uint64_t rhs) {
+        return descending ? lhs < rhs : lhs > rhs;
+    };
+    
+    //Reads a consistent member, retrying while it is being replaced
+    auto read = [slots](int index, uint64_t& genome) {
+        
+        while (true) {
+            
+            uint64_t score = slots[index].score.load();
+            if (score == kBusySlot) continue;
+            
+            genome = slots[index].genome.load();
+            if (slots[index].score.load() == score) return score;
+        }
+    };
+    
+    //Binary tournament
+    auto select = [&](uint64_t& genome) {
+        
+        uint64_t first_genome, second_genome;
+        uint64_t first_score = read(utility::RandomInteger(population), first_genome);
+        uint64_t second_score = read(utility::RandomInteger(population), second_genome);
+        
+        genome = better(second_score, first_score) ? second_genome : first_genome;
+    };
+    
+    size_t evaluations = 0;
+    
+    while (!done.load(std::memory_order_relaxed) && !m_cancelled.load(std::memory_order_relaxed)) {
+        
+        //Stop once the budget of evaluations is spent, taking an evaluation only while one is left
+        long long remaining = budget.load(std::memory_order_relaxed);
+        while (remaining > 0 && !budget.compare_exchange_weak(remaining, remaining - 1, std::memory_order_relaxed)) { }
+        
+        if (remaining == 0) {
+            
+            done = true;
+            break;
+        }
+        
+        //The clock is read once in a while
+        if ((evaluations & 63) == 0 && (StopRequested() || EnumerationDone())) {
+            
+            done = true;
+            break;
+        }
+        
+        uint64_t first_parent, second_parent;
+        select(first_parent);
+        select(second_parent);
+        
+        Chromosome child(m_alphabet, first_parent);
+        
+        if (utility::ThrowDice(m_crossover_probability))
+            child = Chromosome::Crossover(child, Chromosome(m_alphabet, second_parent), 0.5);
+        
+        child = Chromosome::Repair(Chromosome::Mutate(child, m_mutation_probability), m_constraints);
+        
+        uint64_t score;
+        evaluations++;
+        try { score = fitness.Score(child); }
+        catch (...) { continue; }
+        
+        uint64_t genome = child.Pack();
+        
+        if (m_progress && better(score, m_progress_score.load(std::memory_order_relaxed)))
+            ReportProgress(fitness, child, score);
+        
+        //Solutions are collected and kept out of the population, which goes on searching
+        if (score == optimal_score && m_solutions) {
+            
+            m_solutions->Insert(genome);
+            continue;
+        }
+        
+        if (score == optimal_score) {
+            
+            //Only the first optimal chromosome is kept
+            bool expected = false;
+            if (solved.compare_exchange_strong(expected, true)) found = genome;
+            
+            done = true;
+            break;
+        }
+        
+        //Replace the worse of two random members, if the child is better than it
+        int first_index = utility::RandomInteger(population);
+        int second_index = utility::RandomInteger(population);
+        int index = better(slots[first_index].score.load(), slots[second_index].score.load()) ? second_index : first_index;
+        
+        uint64_t current = slots[index].score.load();
+        while (current != kBusySlot && better(score, current)) {
+            
+            if (slots[index].score.compare_exchange_weak(current, kBusySlot)) {
+                
+                slots[index].genome.store(genome);
+                slots[index].score.store(score);
+                break;
+            }
+        }
+    }
+    
+    return evaluations;
+}
+
+Chromosome GeneticAlgorithm::Impl::SteadyState(const Fitness& fitness, size_t generations) {
+    
+    //The population is already scored and valid
+    std::unique_ptr<Slot[]> slots(new Slot[m_chromosomes.size()]);
+    for (size_t index = 0 ; index < m_chromosomes.size() ; index++) {
+        
+        slots[index].genome = m_chromosomes[index].first.Pack();
+        slots[index].score = m_chromosomes[index].second;
+    }
+    
+    //A generation is worth as many evaluations as there are members
+    std::atomic<long long> budget(generations ? static_cast<long long>(generations * m_population_size) : -1);
+    std::atomic<uint64_t> found(0);
+    std::atomic<bool> solved(false);
+    std::atomic<bool> done(false);
+    
+    //The workers only report children that improve on the initial best
+    if (m_progress) {
+        
+        auto best = std::min_element(m_chromosomes.begin(), m_chromosomes.end(), [&](const scored_chromosome& lhs, const scored_chromosome& rhs) {
+            return fitness.Descending() ? lhs.second < rhs.second : lhs.second > rhs.second;
+        });
+        
+        ReportProgress(fitness, best->first, best->second);
+    }
+    
+    size_t threads = m_threads ? m_threads : std::max(1u, std::thread::hardware_concurrency());
+    std::vector<size_t> evaluations(threads, 0);
+    std::vector<std::thread> workers;
+    
+    for (size_t index = 0 ; index < threads ; index++) {
+        workers.push_back(std::thread([&, index]() {
+            evaluations[index] = SteadyStateWorker(fitness, slots.get(), budget, found, solved, done);
+        }));
+    }
+    
+    for (auto& worker : workers) worker.join();
+    
+    m_timed_out = !solved && m_has_deadline && std::chrono::steady_clock::now() >= m_deadline;
+    
+    for (const auto thread_evaluations : evaluations)
+        m_evaluations += thread_evaluations;
+    
+    //Copy the shared population back
+    for (size_t index = 0 ; index < m_chromosomes.size() ; index++) {
+        
+        m_chromosomes[index].first = Chromosome(m_alphabet, slots[index].genome);
+        m_chromosomes[index].second = slots[index].score;
+    }
+    
+    std::sort(m_chromosomes.begin(), m_chromosomes.end(), [&](const scored_chromosome& lhs, const scored_chromosome& rhs){
+        
+        return fitness.Descending()
+        ? lhs.second < rhs.second
+        : lhs.second > rhs.second;
+    });
+    
+    Report(m_evaluations / m_population_size);
+    
+    return solved ? Chromosome(m_alphabet, found) : m_chromosomes.begin()->first;
+}
+
+Chromosome GeneticAlgorithm::Impl::OutOfCore(const Fitness& fitness, size_t generations) {
+    
+    typedef MappedPopulation::Member Member;
+    
+    MappedPopulation population(m_population_file, m_population_size);
+    
+    const bool descending = fitness.Descending();
+    const size_t optimal_score = fitness.OptimalScore();
+    
+    auto better = [descending](uint64_t lhs, uint64_t rhs) {
+        return descending ? lhs < rhs : lhs > rhs;
+    };
+    
+    //The best members of the previous generation, and of the current one as a heap with the worst on top
+    size_t elite_size = std::max<size_t>(1, std::min(kMaxElite, m_population_size / 5));
+    std::vector<Member> elite, next_elite;
+    
+    auto worst_on_top = [&](const Member& lhs, const Member& rhs) { return better(lhs.score, rhs.score); };
+    
+    auto offer = [&](const Member& member) {
+        
+        if (next_elite.size() < elite_size) {
+            
+            next_elite.push_back(member);
+            std::push_heap(next_elite.begin(), next_elite.end(), worst_on_top);
+        }
+        else if (better(member.score, next_elite.front().score)) {
+            
+            std::pop_heap(next_elite.begin(), next_elite.end(), worst_on_top);
+            next_elite.back() = member;
+            std::push_heap(next_elite.begin(), next_elite.end(), worst_on_top);
+        }
+    };
+    
+    bool solved = false;
+    uint64_t found = 0;
+    
+    //Solutions are collected and replaced when enumerating, otherwise the first one ends the search
+    auto settle = [&](Member& member) {
+        
+        while (member.score == optimal_score && m_solutions) {
+            
+            m_solutions->Insert(member.genome);
+            
+            Chromosome chromosome(m_alphabet, m_constraints);
+            member.score = FindValidScoreOrReplace(fitness, chromosome, m_alphabet, m_constraints, m_evaluations);
+            member.genome = chromosome.Pack();
+        }
+        
+        if (member.score != optimal_score) return false;
+        
+        solved = true;
+        found = member.genome;
+        
+        return true;
+    };
+    
+    auto score_offspring = [&](const Chromosome& chromosome, uint64_t& score) {
+        
+        m_evaluations++;
+        try { score = fitness.Score(chromosome); }
+        catch (...) { return false; }
+        
+        return true;
+    };
+    
+    //The first pass creates the members, a stop during it ends the search before the rest are read
+    size_t created = 0;
+    bool proceed = population.Stream(kStreamChunk, [&](Member* members, size_t count) {
+        
+        for (size_t index = 0 ; index < count ; index++) {
+            
+            //At least one member is scored, so that there is a best one to return
+            if (created && (created & 63) == 0 && (StopRequested() || EnumerationDone())) return false;
+            created++;
+            
+            Chromosome chromosome(m_alphabet, m_constraints);
+            members[index].score = FindValidScoreOrReplace(fitness, chromosome, m_alphabet, m_constraints, m_evaluations);
+            members[index].genome = chromosome.Pack();
+            
+            if (settle(members[index])) return false;
+            offer(members[index]);
+        }
+        
+        return true;
+    });
+    
+    size_t generation = 0;
+    
+    while (proceed && (!generations || generation < generations)) {
+        
+        elite.swap(next_elite);
+        next_elite.clear();
+        
+        auto best = std::min_element(elite.begin(), elite.end(), worst_on_top);
+        ReportProgress(fitness, Chromosome(m_alphabet, best->genome), best->score);
+        
+        proceed = population.Stream(kStreamChunk, [&](Member* members, size_t count) {
+            
+            if (StopRequested() || EnumerationDone()) return false;
+            
+            for (size_t index = 0 ; index < count ; index++) {
+                
+                Member& member = members[index];
+                Chromosome current(m_alphabet, member.genome);
+                
+                //Mutate with a probability and take only better options
+                Chromosome mutated = Chromosome::Repair(Chromosome::Mutate(current, m_mutation_probability), m_constraints);
+                uint64_t score = 0;
+                
+                if (score_offspring(mutated, score) && better(score, member.score)) member = { mutated.Pack(), score };
+                
+                //Crossover with a partner from the index of the best members
+                if (utility::ThrowDice(m_crossover_probability)) {
+                    
+                    Chromosome first(m_alphabet, member.genome);
+                    Chromosome second(m_alphabet, elite[utility::RandomInteger(static_cast<int>(elite.size()))].genome);
+                    
+                    if (utility::ThrowDice(0.5)) std::swap(first, second);
+                    
+                    Chromosome crossover = Chromosome::Repair(Chromosome::Crossover(first, second, 0.5), m_constraints);
+                    
+                    if (score_offspring(crossover, score) && better(score, member.score)) member = { crossover.Pack(), score };
+                }
+                
+                if (settle(member)) return false;
+                offer(member);
+            }
+            
+            return true;
+        });
+        
+        if (proceed) generation++;
+    }
+    
+    m_timed_out = !solved && m_has_deadline && std::chrono::steady_clock::now() >= m_deadline;
+    
+    //Only the index is kept in memory, it stands for the population
+    m_chromosomes.clear();
+    for (const auto& member : elite) m_chromosomes.push_back(scored_chromosome(Chromosome(m_alphabet, member.genome), member.score));
+    for (const auto& member : next_elite) m_chromosomes.push_back(scored_chromosome(Chromosome(m_alphabet, member.genome), member.score));
+    
+    std::sort(m_chromosomes.begin(), m_chromosomes.end(), [&](const scored_chromosome& lhs, const scored_chromosome& rhs){
+        
+        return fitness.Descending()
+        ? lhs.second < rhs.second
+        : lhs.second > rhs.second;
+    });
+    
+    if (solved) ReportProgress(fitness, Chromosome(m_alphabet, found), optimal_score);
+    
+    Report(generation);
+    
+    return solved ? Chromosome(m_alphabet, found) : m_chromosomes.begin()->first;
+}
+
+size_t GeneticAlgorithm::Impl::IslandWorker(const Fitness& fitness,
+                                            Member* members,
+                                            size_t size,
+                                            Inbox& inbox,
+                                            Inbox& neighbour,
+                                            size_t generations,
+                                            std::atomic<uint64_t>& found,
+                                            std::atomic<bool>& solved,
+                                            std::atomic<bool>& done,
+                                            size_t& performed) {
+    
+    const int population = static_cast<int>(size);
+    const bool descending = fitness.Descending();
+    const size_t optimal_score = fitness.OptimalScore();
+    
+    auto better = [descending](size_t lhs, size_t rhs) {
+        return descending ? lhs < rhs : lhs > rhs;
+    };
+    
+    size_t evaluations = 0;
+    performed = 0;
+    
+    //Solutions are collected and replaced when enumerating, otherwise the first one ends the search
+    auto settle = [&](Member& member, Chromosome& chromosome) {
+        
+        while (member.score == optimal_score && m_solutions) {
+            
+            m_solutions->Insert(member.genome);
+            
+            chromosome = Chromosome(m_alphabet, m_constraints);
+            member.score = FindValidScoreOrReplace(fitness, chromosome, m_alphabet, m_constraints, evaluations);
+            member.genome = chromosome.Pack();
+        }
+        
+        if (member.score != optimal_score) return false;
+        
+        bool expected = false;
+        if (solved.compare_exchange_strong(expected, true)) found = member.genome;
+        
+        done = true;
+        return true;
+    };
+    
+    //Created on the island's thread, so the members are written first from its node
+    for (size_t index = 0 ; index < size ; index++) {
+        
+        //A large island can outlast the time budget, the members that were not scored yet repeat a scored one
+        if (index && (index & 63) == 0 && (done.load(std::memory_order_relaxed) || StopRequested() || EnumerationDone())) {
+            
+            std::fill(members + index, members + size, members[0]);
+            done = true;
+            return evaluations;
+        }
+        
+        Chromosome chromosome(m_alphabet, m_constraints);
+        members[index].score = FindValidScoreOrReplace(fitness, chromosome, m_alphabet, m_constraints, evaluations);
+        members[index].genome = chromosome.Pack();
+        
+        if (m_progress && better(members[index].score, m_progress_score.load(std::memory_order_relaxed)))
+            ReportProgress(fitness, chromosome, members[index].score);
+        
+        if (settle(members[index], chromosome)) {
+            
+            //The rest of the island is never read, but is kept valid
+            std::fill(members + index + 1, members + size, members[index]);
+            return evaluations;
+        }
+    }
+    
+    //Scratch space of the migrations, allocated here as well
+    std::vector<Member> ranked, arrivals;
+    
+    while (!done.load(std::memory_order_relaxed) && (!generations || performed < generations)) {
+        
+        for (size_t bred = 0 ; bred < size ; bred++) {
+            
+            //The clock is read once in a while
+            if ((bred & 63) == 0 && (done.load(std::memory_order_relaxed) || StopRequested() || EnumerationDone())) {
+                
+                done = true;
+                break;
+            }
+            
+            //Binary tournaments
+            const Member& first = members[utility::RandomInteger(population)];
+            const Member& second = members[utility::RandomInteger(population)];
+            const Member& third = members[utility::RandomInteger(population)];
+            const Member& fourth = members[utility::RandomInteger(population)];
+            
+            Chromosome child(m_alphabet, better(second.score, first.score) ? second.genome : first.genome);
+            
+            if (utility::ThrowDice(m_crossover_probability))
+                child = Chromosome::Crossover(child, Chromosome(m_alphabet, better(fourth.score, third.score) ? fourth.genome : third.genome), 0.5);
+            
+            child = Chromosome::Repair(Chromosome::Mutate(child, m_mutation_probability), m_constraints);
+            
+            size_t score;
+            evaluations++;
+            try { score = fitness.Score(child); }
+            catch (...) { continue; }
+            
+            if (m_progress && better(score, m_progress_score.load(std::memory_order_relaxed)))
+                ReportProgress(fitness, child, score);
+            
+            if (score == optimal_score && m_solutions) {
+                
+                m_solutions->Insert(child.Pack());
+                continue;
+            }
+            
+            if (score == optimal_score) {
+                
+                bool expected = false;
+                if (solved.compare_exchange_strong(expected, true)) found = child.Pack();
+                
+                done = true;
+                break;
+            }
+            
+            //Replace the worse of two random members, if the child is better than it
+            Member& first_candidate = members[utility::RandomInteger(population)];
+            Member& second_candidate = members[utility::RandomInteger(population)];
+            Member& replaced = better(first_candidate.score, second_candidate.score) ? second_candidate : first_candidate;
+            
+            if (better(score, replaced.score)) replaced = { child.Pack(), score };
+        }
+        
+        if (done.load(std::memory_order_relaxed)) break;
+        
+        performed++;
+        
+        if (!m_migration_interval || !m_migrants || performed % m_migration_interval || &inbox == &neighbour) continue;
+        
+        //The best members leave in a single batch
+        size_t migrants = std::min(m_migrants, size);
+        ranked.assign(members, members + size);
+        std::partial_sort(ranked.begin(), ranked.begin() + migrants, ranked.end(), [&](const Member& lhs, const Member& rhs) {
+            return better(lhs.score, rhs.score);
+        });
+        
+        {
+            std::lock_guard<std::mutex> lock(neighbour.mutex);
+            
+            //A slower neighbour only gets the latest batches
+            if (neighbour.members.size() >= 4 * migrants)
+                neighbour.members.erase(neighbour.members.begin(), neighbour.members.begin() + migrants);
+            
+            neighbour.members.insert(neighbour.members.end(), ranked.begin(), ranked.begin() + migrants);
+        }
+        
+        {
+            std::lock_guard<std::mutex> lock(inbox.mutex);
+            arrivals.swap(inbox.members);
+            inbox.members.clear();
+        }
+        
+        //Arrivals replace the worst members if they are better
+        for (const auto& arrival : arrivals) {
+            
+            Member* worst = members;
+            for (size_t index = 1 ; index < size ; index++)
+                if (better(worst->score, members[index].score)) worst = &members[index];
+            
+            if (better(arrival.score, worst->score)) *worst = arrival;
+        }
+    }
+    
+    return evaluations;
+}
+
+Chromosome GeneticAlgorithm::Impl::Islands(const Fitness& fitness, size_t generations) {
+    
+    //The processors node by node, so that the ring only crosses nodes once per node
+    std::vector<std::pair<int, int>> processors;
+    for (const auto& node : topology::Nodes())
+        for (const auto cpu : node.cpus)
+            processors.push_back(std::make_pair(cpu, node.id));
+    
+    size_t islands = m_threads ? m_threads : processors.size();
+    size_t size = std::max<size_t>(2, m_population_size / islands);
+    
+    if (m_verbose && islands * size != m_population_size)
+        std::cout << "The population is split into " << islands << " islands of " << size << " members (" << islands * size << " in total)\n";
+    
+    std::unique_ptr<Inbox[]> inboxes(new Inbox[islands]);
+    std::vector<Member*> members(islands, NULL);
+    std::vector<size_t> evaluations(islands, 0);
+    std::vector<size_t> performed(islands, 0);
+    std::vector<std::exception_ptr> errors(islands);
+    
+    //Without placement the population is allocated (and zeroed) by this thread, as a single population would be
+    std::unique_ptr<Member[]> shared;
+    if (!m_numa_placement) {
+        
+        shared.reset(new Member[islands * size]());
+        for (size_t index = 0 ; index < islands ; index++) members[index] = shared.get() + index * size;
+    }
+    
+    std::atomic<uint64_t> found(0);
+    std::atomic<bool> solved(false);
+    std::atomic<bool> done(false);
+    
+    std::vector<std::thread> workers;
+    
+    for (size_t index = 0 ; index < islands ; index++) {
+        workers.push_back(std::thread([&, index]() {
+            
+            try {
+                
+                if (m_numa_placement) {
+                    
+                    const auto& processor = processors[index % processors.size()];
+                    
+                    //Pinned before allocating, so that first touch puts the island on the processor's node
+                    topology::PinThread(processor.first);
+                    members[index] = static_cast<Member*>(topology::Allocate(size * sizeof(Member), processor.second));
+                }
+                
+                evaluations[index] = IslandWorker(fitness, members[index], size, inboxes[index], inboxes[(index + 1) % islands], generations, found, solved, done, performed[index]);
+            }
+            catch (...) {
+                
+                errors[index] = std::current_exception();
+                done = true;
+            }
+        }));
+    }
+    
+    for (auto& worker : workers) worker.join();
+    
+    m_timed_out = !solved && m_has_deadline && std::chrono::steady_clock::now() >= m_deadline;
+    
+    for (const auto island_evaluations : evaluations)
+        m_evaluations += island_evaluations;
+    
+    //Gather the islands as the population
+    m_chromosomes.clear();
+    for (size_t index = 0 ; index < islands ; index++) {
+        
+        if (members[index] && !errors[index])
+            for (size_t member = 0 ; member < size ; member++)
+                m_chromosomes.push_back(scored_chromosome(Chromosome(m_alphabet, members[index][member].genome), members[index][member].score));
+        
+        if (m_numa_placement) topology::Free(members[index], size * sizeof(Member));
+    }
+    
+    for (const auto& error : errors)
+        if (error) std::rethrow_exception(error);
+    
+    std::sort(m_chromosomes.begin(), m_chromosomes.end(), [&](const scored_chromosome& lhs, const scored_chromosome& rhs){
+        
+        return fitness.Descending()
+        ? lhs.second < rhs.second
+        : lhs.second > rhs.second;
+    });
+    
+    Report(*std::max_element(performed.begin(), performed.end()));
+    
+    return solved ? Chromosome(m_alphabet, found) : m_chromosomes.begin()->first;
+}
+
+void GeneticAlgorithm::Impl::SetDeduplication(bool enabled) { m_deduplication_enabled = enabled; }
+
+size_t GeneticAlgorithm::Impl::Evaluations() const { return m_evaluations; }
+
+size_t GeneticAlgorithm::Impl::Generations() const { return m_generations; }
+
+size_t GeneticAlgorithm::Impl::EvaluationsSaved() const { return m_evaluations_saved; }
+
+size_t GeneticAlgorithm::Impl::ShortCircuited() const { return m_short_circuited; }
+
+bool GeneticAlgorithm::Impl::ScoreOffspring(const Fitness& fitness, const Chromosome& chromosome, size_t& score) {
+    
+    if (m_deduplication) {
+        
+        //Known chromosomes are either the parents or members that are already in the population
+        if (m_known_scores.count(chromosome.Hash())) {
+            
+            m_evaluations_saved++;
+            return false;
+        }
+    }
+    
+    m_evaluations++;
+    try { score = fitness.Score(chromosome); }
+    catch (...) { return false; }
+    
+    if (m_deduplication) m_known_scores[chromosome.Hash()] = score;
+    
+    return true;
+}
+
+void GeneticAlgorithm::Impl::ReplaceDuplicates(const Fitness& fitness) {
+    
+    if (!m_deduplication) return;
+    
+    std::unordered_map<size_t, size_t> seen;
+    seen.reserve(m_chromosomes.size());
+    
+    bool replaced = false;
+    
+    //The population is sorted so the first occurrence is kept
+    for (size_t index = 0 ; index < m_chromosomes.size() ; index++) {
+        
+        scored_chromosome& member = m_chromosomes[index];
+        if (seen.insert({ member.first.Hash(), index }).second) continue;
+        
+        member.first = utility::ThrowDice(0.5)
+        ? Chromosome::Repair(Chromosome::Mutate(member.first, 0.5), m_constraints)
+        : Chromosome(m_alphabet, m_constraints);
+        
+        member.second = FindValidScoreOrReplace(fitness, member.first, m_alphabet, m_constraints, m_evaluations);
+        m_known_scores[member.first.Hash()] = member.second;
+        replaced = true;
+    }
+    
+    if (!replaced) return;
+    
+    //Breeding picks partners by rank, so the replacements take the rank of their score
+    std::sort(m_chromosomes.begin(), m_chromosomes.end(), [&](const scored_chromosome& lhs, const scored_chromosome& rhs){
+        
+        return fitness.Descending()
+        ? lhs.second < rhs.second
+        : lhs.second > rhs.second;
+    });
+}
+
+void GeneticAlgorithm::Impl::Report(size_t generations) {
+    
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - m_start;
+    m_evaluations_per_second = elapsed.count() > 0 ? m_evaluations / elapsed.count() : 0;
+    m_generations = generations;
+    
+    if (m_scheduled) m_scheduling = m_scheduler->Totals();
+    
+    //The counters of the fitness are shared by all the searches that use it
+    size_t scored = m_fitness->Scored() - m_scored_start;
+    m_short_circuited = m_fitness->ShortCircuited() - m_short_circuited_start;
+    
+    if (!m_verbose) return;
+    
+    std::cout << "Generations: " << generations << '\n';
+    if (m_stagnation_window) std::cout << "Restarts: " << m_restarts << '\n';
+    
+    if (m_mode == GeneticAlgorithm::kGenerational && m_deduplication && m_population_file.empty())
+        std::cout << "Evaluations: " << m_evaluations << " (saved " << m_evaluations_saved << ")\n";
+    else
+        std::cout << "Evaluations: " << m_evaluations << '\n';
+    
+    std::cout << "Evaluations per second: " << static_cast<size_t>(m_evaluations_per_second) << '\n';
+    
+    if (m_short_circuited)
+        std::cout << "Short-circuited: " << m_short_circuited << " of " << scored << " (" << 100.0 * m_short_circuited / scored << "%)\n";
+    
+    if (m_scheduled) {
+        
+        double total = m_scheduling.busy_seconds + m_scheduling.idle_seconds;
+        std::cout
+        << "Tasks: " << m_scheduling.tasks << " (stolen " << m_scheduling.steals << ", failed steals " << m_scheduling.failed_steals << ")\n"
+        << "Idle: " << (total > 0 ? 100 * m_scheduling.idle_seconds / total : 0) << "%\n";
+    }
+    
+    if (!m_population_file.empty() && m_mode == GeneticAlgorithm::kGenerational) {
+        
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        
+#ifdef __APPLE__
+        std::cout << "Peak resident set size: " << usage.ru_maxrss / 1024 << " KB\n";
+#else
+        std::cout << "Peak resident set size: " << usage.ru_maxrss << " KB\n";
+#endif
+    }
+    
+    if (!m_solutions) return;
+    
+    //The time since the last new solution shows if more are likely to be found
+    auto discoveries = m_solutions->Discoveries();
+    std::cout << "Solutions: " << discoveries.size() << '\n';
+    
+    if (!discoveries.empty()) {
+        
+        std::cout
+        << "First solution after: " << discoveries.front().second << " seconds\n"
+        << "Last new solution after: " << discoveries.back().second << " seconds (of " << elapsed.count() << ")\n";
+    }
+}
+
+void GeneticAlgorithm::Impl::CollectSolutions(const Fitness& fitness) {
+    
+    const size_t optimal_score = fitness.OptimalScore();
+    
+    for (auto& member : m_chromosomes) {
+        
+        //A new random chromosome can be a solution too
+        while (member.second == optimal_score) {
+            
+            m_solutions->Insert(member.first.Pack());
+            
+            member.first = Chromosome(m_alphabet, m_constraints);
+            member.second = FindValidScoreOrReplace(fitness, member.first, m_alphabet, m_constraints, m_evaluations);
+        }
+    }
+}
+
+bool GeneticAlgorithm::Impl::EnumerationDone() const {
+    return m_solutions && m_max_solutions && m_solutions->Size() >= m_max_solutions;
+}
+
+bool GeneticAlgorithm::Impl::StopRequested() const {
+    
+    return m_cancelled.load(std::memory_order_relaxed) ||
+           m_token.Cancelled() ||
+           (m_has_deadline && std::chrono::steady_clock::now() >= m_deadline);
+}
+
+void GeneticAlgorithm::Impl::ReportProgress(const Fitness& fitness, const Chromosome& chromosome, size_t score) {
+    
+    if (!m_progress) return;
+    
+    std::lock_guard<std::mutex> lock(m_progress_mutex);
+    
+    //Another thread may have reported a better one in the meantime
+    size_t reported = m_progress_score.load(std::memory_order_relaxed);
+    if (m_progress_reported.load(std::memory_order_relaxed) && !(fitness.Descending() ? score < reported : score > reported))
+        return;
+    
+    m_progress_score = score;
+    m_progress_reported = true;
+    
+    m_progress(chromosome, score);
+}
+
+void GeneticAlgorithm::Impl::SetStagnation(size_t window, float elite_fraction, GeneticAlgorithm::Restart strategy) {
+    
+    m_stagnation_window = window;
+    m_elite_fraction = elite_fraction;
+    m_restart_strategy = strategy;
+}
+
+size_t GeneticAlgorithm::Impl::Restarts() const { return m_restarts; }
+
+void GeneticAlgorithm::Impl::DetectStagnation(const Fitness& fitness) {
+    
+    if (!m_stagnation_window) return;
+    
+    size_t best_score = m_chromosomes.begin()->second;
+    
+    double mean_score = 0;
+    for (const auto& chromosome : m_chromosomes)
+        mean_score += chromosome.second;
+    mean_score /= m_chromosomes.size();
+    
+    //Take the scores of the first generation (or the first after a restart) as the baseline
+    if (m_scores_reset) {
+        
+        if (m_restarts == 0) m_best_score = best_score;
+        m_mean_score = mean_score;
+        m_scores_reset = false;
+        return;
+    }
+    
+    bool improved_best = fitness.Descending() ? best_score < m_best_score : best_score > m_best_score;
+    bool improved_mean = fitness.Descending() ? mean_score < m_mean_score : mean_score > m_mean_score;
+    
+    if (improved_best) m_best_score = best_score;
+    if (improved_mean) m_mean_score = mean_score;
+    
+    if (improved_best || improved_mean) {
+        
+        m_stagnant_generations = 0;
+        return;
+    }
+    
+    if (++m_stagnant_generations < m_stagnation_window) return;
+    
+    PartialRestart(fitness);
+    
+    m_restarts++;
+    m_stagnant_generations = 0;
+    m_scores_reset = true;
+}
+
+void GeneticAlgorithm::Impl::PartialRestart(const Fitness& fitness) {
+    
+    //Always keep at least the best chromosome
+    size_t elites = std::max<size_t>(1, m_elite_fraction * m_chromosomes.size());
+    
+    for (size_t index = elites ; index < m_chromosomes.size() ; index++) {
+        
+        bool mutate = false;
+        switch (m_restart_strategy) {
+            case GeneticAlgorithm::kReseed:         mutate = false; break;
+            case GeneticAlgorithm::kHeavyMutation:  mutate = true; break;
+            case GeneticAlgorithm::kMixed:          mutate = (index % 2 == 0); break;
+        }
+        
+        scored_chromosome& member = m_chromosomes[index];
+        
+        if (mutate) {
+            
+            const Chromosome& elite = m_chromosomes[utility::RandomInteger(static_cast<int>(elites))].first;
+            member.first = Chromosome::Repair(Chromosome::Mutate(elite, 0.5), m_constraints);
+        }
+        else member.first = Chromosome(m_alphabet, m_constraints);
+        
+        //A placeholder score would rank the replacements (0 is optimal for descending fitness)
+        member.second = FindValidScoreOrReplace(fitness, member.first, m_alphabet, m_constraints, m_evaluations);
+        if (m_deduplication) m_known_scores[member.first.Hash()] = member.second;
+    }
+    
+    //Breeding picks partners by rank
+    std::sort(m_chromosomes.begin(), m_chromosomes.end(), [&](const scored_chromosome& lhs, const scored_chromosome& rhs){
+        
+        return fitness.Descending()
+        ? lhs.second < rhs.second
+        : lhs.second > rhs.second;
+    });
+}
+
+Chromosome* GeneticAlgorithm::Impl::UpdateChromosomeScores(const Fitness& fitness) {
+    
+    //Scores of the previous generation are reused, everything else is forgotten
+    std::unordered_map<size_t, size_t> known_scores;
+    if (m_deduplication) known_scores.reserve(m_chromosomes.size() * 2);
+    
+    //Update Chromosomes so they contain valid chromosomes with scores
+    size_t index = 0;
+    for (auto begin = m_chromosomes.begin(), end = m_chromosomes.end() ;
+         begin != end ;
+         begin++, index++) {
+        
+        //A large population can outlast the time budget, the members that were not scored yet are dropped
+        if (index && (index & 63) == 0 && StopRequested()) {
+            
+            m_chromosomes.erase(begin, end);
+            break;
+        }
+        
+        auto known = m_deduplication ? m_known_scores.find(begin->first.Hash()) : m_known_scores.end();
+        if (known != m_known_scores.end()) {
+            
+            begin->second = known->second;
+            m_evaluations_saved++;
+        }
+        else begin->second = FindValidScoreOrReplace(fitness, begin->first, m_alphabet, m_constraints, m_evaluations);
+        
+        if (m_deduplication) known_scores[begin->first.Hash()] = begin->second;
+        
+        //Check for valid results, all of them are collected when enumerating
+        if (begin->second == fitness.OptimalScore() && !m_solutions)
+            return &begin->first;
+    }
+    
+    m_known_scores.swap(known_scores);
+    
+    //Didnt find answer
+    return NULL;
+}
+
+Chromosome* GeneticAlgorithm::Impl::UpdateChromosomeScores(const Fitness& fitness, WorkStealingScheduler& scheduler) {
+    
+    std::vector<size_t> evaluations(scheduler.Threads(), 0);
+    std::vector<size_t> saved(scheduler.Threads(), 0);
+    std::vector<char> scored(m_chromosomes.size(), 0);
+    
+    //The known scores are only read while the chunks run
+    scheduler.ParallelFor(m_chromosomes.size(), kChunk, [&](size_t begin, size_t end, size_t worker) {
+        
+        size_t chunk_evaluations = 0, chunk_saved = 0;
+        
+        for (size_t index = begin ; index < end ; index++) {
             
-            return fitness->Descending()
-            ? lhs.second < rhs.second
-            : lhs.second > rhs.second;
-        });
+            //The first member is always scored, so that there is a best one
+            if (index && ((index - begin) & 63) == 0 && StopRequested()) break;
+            
+            scored_chromosome& member = m_chromosomes[index];
+            
+            auto known = m_deduplication ? m_known_scores.find(member.first.Hash()) : m_known_scores.end();
+            if (known != m_known_scores.end()) {
+                
+                member.second = known->second;
+                chunk_saved++;
+            }
+            else member.second = FindValidScoreOrReplace(fitness, member.first, m_alphabet, m_constraints, chunk_evaluations);
+            
+            scored[index] = 1;
+        }
+        
+        evaluations[worker] += chunk_evaluations;
+        saved[worker] += chunk_saved;
+    });
+    
+    //The members that were not scored before a stop are dropped
+    size_t kept = 0;
+    for (size_t index = 0 ; index < m_chromosomes.size() ; index++)
+        if (scored[index]) m_chromosomes[kept++] = std::move(m_chromosomes[index]);
+    
+    m_chromosomes.erase(m_chromosomes.begin() + kept, m_chromosomes.end());
+    
+    for (size_t worker = 0 ; worker < scheduler.Threads() ; worker++) {
+        
+        m_evaluations += evaluations[worker];
+        m_evaluations_saved += saved[worker];
+    }
+    
+    //Scores of the previous generation are reused, everything else is forgotten
+    std::unordered_map<size_t, size_t> known_scores;
+    if (m_deduplication) {
+        
+        known_scores.reserve(m_chromosomes.size() * 2);
+        for (const auto& member : m_chromosomes) known_scores[member.first.Hash()] = member.second;
+    }
+    
+    m_known_scores.swap(known_scores);
+    
+    //Check for valid results, all of them are collected when enumerating
+    if (!m_solutions)
+        for (auto& member : m_chromosomes)
+            if (member.second == fitness.OptimalScore()) return &member.first;
+    
+    return NULL;
+}
+
+void GeneticAlgorithm::Impl::BreedGeneration(const Fitness& fitness) {
+    
+    size_t bred = 0;
+    
+    for (std::vector<scored_chromosome>::iterator begin = m_chromosomes.begin(), end = m_chromosomes.end() ;
+         begin != end ;
+         begin++) {
+        
+        //A large generation can outlast the time budget, the members that were not bred yet stay as they are
+        if ((bred++ & 63) == 0 && StopRequested()) return;
+        
+        //Mutate with a probability and take only better options
+        Chromosome mutated = Chromosome::Repair(Chromosome::Mutate(begin->first, m_mutation_probability), m_constraints);
+        size_t mutated_score = 0;
         
-        //Reached limit of generations
-        if (counted_generations++ == generations) {
+        if (ScoreOffspring(fitness, mutated, mutated_score) &&
+            (fitness.Descending()
+             ? mutated_score < begin->second
+             : mutated_score > begin->second)) {
             
-            std::cout << "Generations: " << counted_generations - 1 << '\n';
-            return m_chromosomes.begin()->first;
+            begin->first = mutated;
+            begin->second = mutated_score;
         }
         
-        //Perform changes to the chromosomes themselfs
-        for (std::vector<scored_chromosome>::iterator begin = m_chromosomes.begin(), end = m_chromosomes.end() ;
-             begin != end ;
-             begin++) {
+        //Crossover with a probability only if its beneficial
+        if (utility::ThrowDice(m_crossover_probability)) {
             
-            //Mutate with a probability and take only better options
-            Chromosome mutated = Chromosome::Mutate(begin->first, m_mutation_probability);
-            try {
+            auto first_chromosome = begin;
+            auto second_chromosome = m_chromosomes.begin() + static_cast<int>(utility::RandomProbability() * std::round(m_chromosomes.size() / 5.0f));
+            
+            //Avoid crossing over with self
+            if (first_chromosome == second_chromosome) continue;
+            
+            //Perform flips to chromosomes in order to randomize parts that are exchanged to avoid local maximum
+            if (utility::ThrowDice(0.5)) { auto temp = first_chromosome; first_chromosome = second_chromosome; second_chromosome = temp; }
+            
+            Chromosome crossover = Chromosome::Repair(Chromosome::Crossover(first_chromosome->first, second_chromosome->first, 0.5), m_constraints);
+            size_t crossover_score = 0;
+            
+            if (ScoreOffspring(fitness, crossover, crossover_score) &&
+                (fitness.Descending()
+                 ? crossover_score < begin->second
+                 : crossover_score > begin->second)) {
                 
-                size_t mutated_score = fitness->Score(mutated);
-
-                if (fitness->Descending()
-                    ? mutated_score < begin->second
-                    : mutated_score > begin->second) {
-                    
-                    begin->first = mutated;
-                    begin->second = mutated_score;
-                }
+                begin->first = crossover;
+                begin->second = crossover_score;
             }
-            catch (...) { }
+        }
+    }
+}
+
+void GeneticAlgorithm::Impl::BreedGeneration(const Fitness& fitness, OffspringPipeline& pipeline) {
+    
+    pipeline.Breed(m_chromosomes,
+                   m_deduplication ? &m_known_scores : NULL,
+                   [&](size_t member, const Chromosome& offspring, size_t score) {
+                       
+                       if (m_deduplication) m_known_scores[offspring.Hash()] = score;
+                       
+                       //Take only better options
+                       scored_chromosome& current = m_chromosomes[member];
+                       if (fitness.Descending() ? score < current.second : score > current.second) {
+                           
+                           current.first = offspring;
+                           current.second = score;
+                       }
+                   },
+                   m_evaluations,
+                   m_evaluations_saved);
+}
+
+void GeneticAlgorithm::Impl::BreedGeneration(const Fitness& fitness, WorkStealingScheduler& scheduler) {
+    
+    //Crossover partners come from the best fifth as it was at the start of the generation
+    size_t partners_size = static_cast<size_t>(std::round(m_chromosomes.size() / 5.0f));
+    std::vector<scored_chromosome> partners(m_chromosomes.begin(), m_chromosomes.begin() + std::max<size_t>(1, partners_size));
+    
+    const bool descending = fitness.Descending();
+    
+    //Scores learned by every worker, added to the known scores once the generation is done
+    std::vector<std::vector<std::pair<size_t, size_t>>> learned(scheduler.Threads());
+    std::vector<size_t> evaluations(scheduler.Threads(), 0);
+    std::vector<size_t> saved(scheduler.Threads(), 0);
+    
+    scheduler.ParallelFor(m_chromosomes.size(), kChunk, [&](size_t begin, size_t end, size_t worker) {
+        
+        //The members of a skipped chunk stay as they are
+        if (StopRequested()) return;
+        
+        size_t chunk_evaluations = 0, chunk_saved = 0;
+        
+        auto score_offspring = [&](const Chromosome& chromosome, size_t& score) {
             
-            //Crossover with a probability only if its beneficial
-            if (utility::ThrowDice(m_crossover_probability)) {
+            if (m_deduplication && m_known_scores.count(chromosome.Hash())) {
                 
-                auto first_chromosome = begin;
-                auto second_chromosome = m_chromosomes.begin() + static_cast<int>(utility::RandomProbability() * std::round(m_chromosomes.size() / 5.0f));
+                chunk_saved++;
+                return false;
+            }
+            
+            chunk_evaluations++;
+            try { score = fitness.Score(chromosome); }
+            catch (...) { return false; }
+            
+            if (m_deduplication) learned[worker].push_back(std::make_pair(chromosome.Hash(), score));
+            
+            return true;
+        };
+        
+        for (size_t index = begin ; index < end ; index++) {
+            
+            scored_chromosome& member = m_chromosomes[index];
+            
+            //Mutate with a probability and take only better options
+            Chromosome mutated = Chromosome::Repair(Chromosome::Mutate(member.first, m_mutation_probability), m_constraints);
+            size_t mutated_score = 0;
+            
+            if (score_offspring(mutated, mutated_score) && (descending ? mutated_score < member.second : mutated_score > member.second)) {
                 
-                //Avoid crossing over with self
-                if (first_chromosome == second_chromosome) continue;
+                member.first = mutated;
+                member.second = mutated_score;
+            }
+            
+            //Crossover with a probability only if its beneficial
+            if (!utility::ThrowDice(m_crossover_probability)) continue;
+            
+            size_t partner = std::min(static_cast<size_t>(utility::RandomProbability() * partners_size), partners.size() - 1);
+            
+            //Avoid crossing over with self
+            if (partner == index) continue;
+            
+            const Chromosome* first_chromosome = &member.first;
+            const Chromosome* second_chromosome = &partners[partner].first;
+            
+            //Perform flips to chromosomes in order to randomize parts that are exchanged to avoid local maximum
+            if (utility::ThrowDice(0.5)) std::swap(first_chromosome, second_chromosome);
+            
+            Chromosome crossover = Chromosome::Repair(Chromosome::Crossover(*first_chromosome, *second_chromosome, 0.5), m_constraints);
+            size_t crossover_score = 0;
+            
+            if (score_offspring(crossover, crossover_score) && (descending ? crossover_score < member.second : crossover_score > member.second)) {
                 
-                //Perform flips to chromosomes in order to randomize parts that are exchanged to avoid local maximum
-                if (utility::ThrowDice(0.5)) { auto temp = first_chromosome; first_chromosome = second_chromosome; second_chromosome = temp; }
+                member.first = crossover;
+                member.second = crossover_score;
+            }
+        }
+        
+        evaluations[worker] += chunk_evaluations;
+        saved[worker] += chunk_saved;
+    });
+    
+    for (size_t worker = 0 ; worker < scheduler.Threads() ; worker++) {
+        
+        m_evaluations += evaluations[worker];
+        m_evaluations_saved += saved[worker];
+        
+        for (const auto& score : learned[worker]) m_known_scores[score.first] = score.second;
+    }
+}
+
+Chromosome GeneticAlgorithm::Impl::FindSolution(const std::string& query, Fitness::Type type, size_t generations) {
+
+    /*
+     * The fitness can now estimate the score for
+     * chromosomes based on information parsed from
+     * the query (parameters and result strings).
+     */
+    std::unique_ptr<Fitness> fitness(Fitness::CreateFitness(query, type));
+    
+    if (m_solution_cache) {
+        
+        auto start = std::chrono::steady_clock::now();
+        
+        //Stored solutions are verified, as the cache can return another query's solution on a hash collision
+        Chromosome solution(Chromosome::elements{});
+        if (m_solution_cache->Find(query, solution)) {
+            
+            Chromosome::Constraints constraints = { fitness->NonZeroLetters(), m_constraints.distinct };
+            bool valid = false;
+            try { valid = solution.Satisfies(constraints) && fitness->Score(solution) == fitness->OptimalScore(); }
+            catch (...) { }
+            
+            if (valid) {
                 
-                Chromosome crossover = Chromosome::Crossover(first_chromosome->first, second_chromosome->first, 0.5);
+                std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+                if (m_verbose) std::cout << "Solution cache hit in " << elapsed.count() << " microseconds\n";
                 
-                try {
-                    
-                    size_t crossover_score = fitness->Score(crossover);
-
-                    if (fitness->Descending()
-                        ? crossover_score < begin->second
-                        : crossover_score > begin->second) {
-                    
-                        begin->first = crossover;
-                        begin->second = crossover_score;
-                    }
-                }
-                catch (...) { }
+                return solution;
             }
         }
     }
+    
+    fitness->SetPreFilter(m_pre_filter);
+    
+    if (m_code_generation && !fitness->GenerateEvaluator() && m_verbose)
+        std::cout << "Code generation is not available, using the interpreter\n";
+    
+    Chromosome result = FindSolution(*fitness, generations);
+    
+    //Write through, only solutions are worth storing
+    if (m_solution_cache && fitness->Score(result) == fitness->OptimalScore())
+        m_solution_cache->Store(query, result);
+    
+    return result;
+}
+
+Chromosome GeneticAlgorithm::Impl::FindSolution(const Fitness& fitness, size_t generations) {
+    
+    Chromosome result = Search(fitness, generations);
+    
+    //A cancellation applies to a single search, a cancelled token to all of them
+    m_was_cancelled = m_cancelled.exchange(false) || m_token.Cancelled();
+    
+    return result;
+}
+
+std::vector<Chromosome> GeneticAlgorithm::Impl::FindAllSolutions(const std::string& query, Fitness::Type type, size_t generations, size_t max_solutions, double seconds) {
+    
+    std::unique_ptr<Fitness> fitness(Fitness::CreateFitness(query, type));
+    
+    fitness->SetPreFilter(m_pre_filter);
+    
+    if (m_code_generation && !fitness->GenerateEvaluator() && m_verbose)
+        std::cout << "Code generation is not available, using the interpreter\n";
+    
+    return FindAllSolutions(*fitness, generations, max_solutions, seconds);
+}
+
+std::vector<Chromosome> GeneticAlgorithm::Impl::FindAllSolutions(const Fitness& fitness, size_t generations, size_t max_solutions, double seconds) {
+    
+    std::string alphabet = utility::Alphabet(fitness.Query());
+    
+    //The search goes on after every solution, so it would never return
+    if (!generations && !max_solutions && seconds <= 0 && m_time_budget <= 0)
+        throw std::invalid_argument("Finding all solutions needs a limit on the generations, the solutions or the time.");
+    
+    SolutionSet solutions;
+    
+    m_solutions = &solutions;
+    m_max_solutions = max_solutions;
+    m_enumeration_seconds = seconds;
+    
+    try { FindSolution(fitness, generations); }
+    catch (...) {
+        
+        m_solutions = NULL;
+        m_enumeration_seconds = 0;
+        throw;
+    }
+    
+    m_solutions = NULL;
+    m_enumeration_seconds = 0;
+    
+    std::vector<Chromosome> result;
+    m_discovery_times.clear();
+    
+    for (const auto& discovery : solutions.Discoveries()) {
+        
+        result.push_back(Chromosome(alphabet, discovery.first));
+        m_discovery_times.push_back(discovery.second);
+    }
+    
+    return result;
+}
+
+const std::vector<double>& GeneticAlgorithm::Impl::DiscoveryTimes() const { return m_discovery_times; }
+
+Chromosome GeneticAlgorithm::Impl::Search(const Fitness& fitness, size_t generations) {
+    
+    m_alphabet = utility::Alphabet(fitness.Query());
+    
+    //Chromosomes are created and repaired so they are valid by construction
+    m_constraints.non_zero = fitness.NonZeroLetters();
+    
+    //Only the generational population keeps chromosomes as they are, everything else keeps them packed
+    bool packed = m_mode != GeneticAlgorithm::kGenerational || !m_population_file.empty() || m_solutions;
+    if (packed && m_alphabet.size() > 16)
+        throw std::length_error("Only the generational mode without a population file supports queries with more than 16 letters.");
+    
+    //A known score is taken by hash, which is the exact packed chromosome up to 16 letters only
+    m_deduplication = m_deduplication_enabled && m_alphabet.size() <= 16;
+    
+    //Start from a fresh population
+    m_chromosomes.clear();
+    m_restarts = 0;
+    m_stagnant_generations = 0;
+    m_scores_reset = true;
+    m_known_scores.clear();
+    m_evaluations = 0;
+    m_evaluations_saved = 0;
+    m_evaluations_per_second = 0;
+    m_start = std::chrono::steady_clock::now();
+    
+    m_fitness = &fitness;
+    m_scored_start = fitness.Scored();
+    m_short_circuited_start = fitness.ShortCircuited();
+    m_short_circuited = 0;
+    
+    //The earlier of the time budgets
+    double seconds = m_time_budget;
+    if (m_enumeration_seconds > 0 && (seconds <= 0 || m_enumeration_seconds < seconds)) seconds = m_enumeration_seconds;
+    
+    m_has_deadline = seconds > 0;
+    m_deadline = m_start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds));
+    m_timed_out = false;
+    
+    m_progress_reported = false;
+    m_scheduled = false;
+    
+    //Every island creates its own population on its own node
+    if (m_mode == GeneticAlgorithm::kIslands) return Islands(fitness, generations);
+    
+    if (!m_population_file.empty() && m_mode == GeneticAlgorithm::kGenerational) return OutOfCore(fitness, generations);
+    
+    //Create chromosomes with random values for each letter, as many as there is time for
+    for (size_t index = 0 ; index < m_population_size ; index++) {
+        
+        if (index && (index & 63) == 0 && StopRequested()) break;
+        m_chromosomes.push_back(scored_chromosome(Chromosome(m_alphabet, m_constraints), 0));
+    }
+    
+    //The draw and scoring stages run for the whole search
+    std::unique_ptr<OffspringPipeline> pipeline;
+    bool pipelined = m_pipeline_depth && m_mode == GeneticAlgorithm::kGenerational;
+    
+    //Stages that share a core are slower than breeding one by one
+    if (pipelined && std::thread::hardware_concurrency() < OffspringPipeline::kStages) {
+        
+        if (m_verbose) std::cout << "The offspring pipeline needs " << OffspringPipeline::kStages << " cores, breeding one by one\n";
+        pipelined = false;
+    }
+    
+    //The stages pass mutations packed
+    if (pipelined && m_alphabet.size() > 16) {
+        
+        if (m_verbose) std::cout << "The offspring pipeline supports up to 16 letters, breeding one by one\n";
+        pipelined = false;
+    }
+    
+    if (pipelined) {
+        
+        pipeline.reset(new OffspringPipeline(fitness,
+                                             m_alphabet.size(),
+                                             m_population_size,
+                                             m_crossover_probability,
+                                             m_mutation_probability,
+                                             m_constraints,
+                                             m_pipeline_depth));
+    }
+    
+    //Chunks of every generation run on the scheduler
+    m_scheduled = m_generation_threads != 1 && m_mode == GeneticAlgorithm::kGenerational && !pipeline;
+    m_scheduling = { 0, 0, 0, 0, 0 };
+    
+    if (m_scheduled) {
+        
+        size_t threads = m_generation_threads ? m_generation_threads : std::max(1u, std::thread::hardware_concurrency());
+        if (!m_scheduler || m_scheduler->Threads() != threads) m_scheduler.reset(new WorkStealingScheduler(threads));
+        
+        m_scheduler->ResetTotals();
+    }
+    
+    //Ensuring that the number of counted generations is above 0 means that it will be equal and stop
+    size_t counted_generations = generations ? 0 : 1;
+    
+    while (true) {
+        
+        
+        Chromosome* result = m_scheduled ? UpdateChromosomeScores(fitness, *m_scheduler) : UpdateChromosomeScores(fitness);
+        
+        //In case a result was found return it
+        if (result) {
+            
+            ReportProgress(fitness, *result, fitness.OptimalScore());
+            Report(counted_generations);
+            return *result;
+        }
+        
+        if (m_solutions) CollectSolutions(fitness);
+        
+        //The steady state mode takes over from the scored initial population
+        if (m_mode == GeneticAlgorithm::kSteadyState)
+            return SteadyState(fitness, generations);
+
+        //Sort so that the best chromosomes are the first
+        std::sort(m_chromosomes.begin(), m_chromosomes.end(), [&](scored_chromosome& lhs, scored_chromosome& rhs){
+            
+            return fitness.Descending()
+            ? lhs.second < rhs.second
+            : lhs.second > rhs.second;
+        });
+        
+        ReportProgress(fitness, m_chromosomes.begin()->first, m_chromosomes.begin()->second);
+        
+        //Reached limit of generations or asked to stop
+        bool stop = StopRequested();
+        if (counted_generations++ == generations || stop || EnumerationDone()) {
+            
+            m_timed_out = stop && m_has_deadline && std::chrono::steady_clock::now() >= m_deadline;
+            Report(counted_generations - 1);
+            return m_chromosomes.begin()->first;
+        }
+        
+        //Restart most of the population if it stopped improving
+        DetectStagnation(fitness);
+        
+        //Identical chromosomes only waste evaluations
+        ReplaceDuplicates(fitness);
+        
+        //Perform changes to the chromosomes themselfs
+        if (pipeline) BreedGeneration(fitness, *pipeline);
+        else if (m_scheduled) BreedGeneration(fitness, *m_scheduler);
+        else BreedGeneration(fitness);
+    }
 }
 
 #pragma mark - GeneticAlgorithm functions
 
-GeneticAlgorithm::GeneticAlgorithm(size_t population_size, float crossover_probability, float mutation_probability) :
-m_pimpl(new Impl(population_size, crossover_probability, mutation_probability))
+GeneticAlgorithm::GeneticAlgorithm(size_t population_size, float crossover_probability, float mutation_probability, size_t pipeline_depth) :
+m_pimpl(new Impl(population_size, crossover_probability, mutation_probability, pipeline_depth))
 { }
 
 Chromosome GeneticAlgorithm::FindSolution(const std::string &query, Fitness::Type type, size_t generations) {
     return m_pimpl->FindSolution(query, type, generations);
 }
 
+Chromosome GeneticAlgorithm::FindSolution(const Fitness& fitness, size_t generations) {
+    return m_pimpl->FindSolution(fitness, generations);
+}
+
+std::vector<Chromosome> GeneticAlgorithm::FindAllSolutions(const std::string& query, Fitness::Type type, size_t generations, size_t max_solutions, double seconds) {
+    return m_pimpl->FindAllSolutions(query, type, generations, max_solutions, seconds);
+}
+
+std::vector<Chromosome> GeneticAlgorithm::FindAllSolutions(const Fitness& fitness, size_t generations, size_t max_solutions, double seconds) {
+    return m_pimpl->FindAllSolutions(fitness, generations, max_solutions, seconds);
+}
+
+const std::vector<double>& GeneticAlgorithm::DiscoveryTimes() const {
+    return m_pimpl->DiscoveryTimes();
+}
+
+void GeneticAlgorithm::SetStagnation(size_t window, float elite_fraction, GeneticAlgorithm::Restart strategy) {
+    m_pimpl->SetStagnation(window, elite_fraction, strategy);
+}
+
+size_t GeneticAlgorithm::Restarts() const {
+    return m_pimpl->Restarts();
+}
+
+void GeneticAlgorithm::SetDeduplication(bool enabled) {
+    m_pimpl->SetDeduplication(enabled);
+}
+
+size_t GeneticAlgorithm::Evaluations() const {
+    return m_pimpl->Evaluations();
+}
+
+size_t GeneticAlgorithm::Generations() const {
+    return m_pimpl->Generations();
+}
+
+size_t GeneticAlgorithm::EvaluationsSaved() const {
+    return m_pimpl->EvaluationsSaved();
+}
+
+size_t GeneticAlgorithm::ShortCircuited() const {
+    return m_pimpl->ShortCircuited();
+}
+
+void GeneticAlgorithm::SetMode(Mode mode, size_t threads) {
+    m_pimpl->SetMode(mode, threads);
+}
+
+void GeneticAlgorithm::SetGenerationThreads(size_t threads) {
+    m_pimpl->SetGenerationThreads(threads);
+}
+
+WorkStealingScheduler::Statistics GeneticAlgorithm::Scheduling() const {
+    return m_pimpl->Scheduling();
+}
+
+void GeneticAlgorithm::SetMigration(size_t interval, size_t migrants) {
+    m_pimpl->SetMigration(interval, migrants);
+}
+
+void GeneticAlgorithm::SetNumaPlacement(bool enabled) {
+    m_pimpl->SetNumaPlacement(enabled);
+}
+
+void GeneticAlgorithm::SetDistinctDigits(bool distinct) {
+    m_pimpl->SetDistinctDigits(distinct);
+}
+
+void GeneticAlgorithm::SetCodeGeneration(bool enabled) {
+    m_pimpl->SetCodeGeneration(enabled);
+}
+
+void GeneticAlgorithm::SetPreFilter(Fitness::Filter filter) {
+    m_pimpl->SetPreFilter(filter);
+}
+
+void GeneticAlgorithm::SetPopulationFile(const std::string& path) {
+    m_pimpl->SetPopulationFile(path);
+}
+
+void GeneticAlgorithm::SetSolutionCache(const std::string& path) {
+    m_pimpl->SetSolutionCache(path);
+}
+
+void GeneticAlgorithm::Cancel() {
+    m_pimpl->Cancel();
+}
+
+bool GeneticAlgorithm::Cancelled() const {
+    return m_pimpl->Cancelled();
+}
+
+void GeneticAlgorithm::SetCancellationToken(const CancellationToken& token) {
+    m_pimpl->SetCancellationToken(token);
+}
+
+void GeneticAlgorithm::SetTimeBudget(double seconds) {
+    m_pimpl->SetTimeBudget(seconds);
+}
+
+bool GeneticAlgorithm::TimedOut() const {
+    return m_pimpl->TimedOut();
+}
+
+void GeneticAlgorithm::SetProgressCallback(const Progress& progress) {
+    m_pimpl->SetProgressCallback(progress);
+}
+
+void GeneticAlgorithm::SetVerbose(bool verbose) {
+    m_pimpl->SetVerbose(verbose);
+}
+
 GeneticAlgorithm::~GeneticAlgorithm() { }
 
@@ -12,12 +12,44 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <functional>
 #include "Chromosome.hpp"
 #include "Fitness.hpp"
+#include "CancellationToken.hpp"
+#include "WorkStealingScheduler.hpp"
 
 class GeneticAlgorithm {
 public:
     
+    /**
+     * Strategies for replacing the non elite chromosomes once the population stagnates.
+     * kReseed replaces them with random chromosomes, kHeavyMutation with heavily mutated
+     * elites and kMixed does half of each.
+     */
+    enum Restart {
+        kReseed = 1,
+        kHeavyMutation,
+        kMixed
+    };
+    
+    /**
+     * Modes of the search. kGenerational breeds the whole population every generation,
+     * kSteadyState runs worker threads that continuously breed single children and
+     * replace worse members without waiting for each other, and kIslands splits the
+     * population into islands that each evolve on their own thread and exchange their
+     * best members once in a while (see SetMigration).
+     */
+    enum Mode {
+        kGenerational = 1,
+        kSteadyState,
+        kIslands
+    };
+    
+    /**
+     * Receives the best chromosome of the search and its score whenever they improve.
+     */
+    typedef std::function<void(const Chromosome& chromosome, size_t score)> Progress;
+    
     /**
      *
      * @param population_size           says how many chromosomes are in population (in one generation).
@@ -34,13 +66,25 @@ public:
      *                                  without any change. If mutation is performed,
      *                                  part of chromosome is changed.
      *
+     * @param pipeline_depth            says how many batches of offspring can wait between the stages
+     *                                  of the offspring pipeline. If it is 0, offspring are bred and scored
+     *                                  one by one. Otherwise the random draws, the breeding and the scoring
+     *                                  run as separate stages on separate threads, on machines with a
+     *                                  core per stage (see OffspringPipeline). With fewer cores the
+     *                                  stages would only take turns, and the stages pass chromosomes
+     *                                  of up to 16 letters, so otherwise offspring are bred one by one.
+     *
      */
     GeneticAlgorithm(size_t population_size,
                      float crossover_probability = 1,
-                     float mutation_probability = 0.1);
+                     float mutation_probability = 0.1,
+                     size_t pipeline_depth = 0);
     
     /**
      * Finds the best solution to the query at the given number of generations.
+     * Queries with more than 16 letters are only supported by the generational mode
+     * without a population file, and throw std::length_error otherwise (as they do
+     * when finding all solutions).
      *
      * @param query         The query string.
      * @param type          The type of fitness to use.
@@ -50,6 +94,295 @@ public:
                             Fitness::Type type,
                             size_t generations = 0);
     
+    /**
+     * Finds the best solution to the fitness' query at the given number of generations.
+     * This allows using a fitness that was created in advance, such as a CompiledFitness.
+     *
+     * @param fitness       The fitness to use.
+     * @param generations   Number of generations to perform.
+     */
+    Chromosome FindSolution(const Fitness& fitness,
+                            size_t generations = 0);
+    
+    /**
+     * Finds every distinct solution of the query that the search comes across. Unlike
+     * FindSolution the search goes on after a solution is found (solutions are collected
+     * and replaced by new random chromosomes, or in steady state mode collected by all the
+     * threads) until one of the budgets is spent. Throws std::invalid_argument if none of
+     * them is set (nor a time budget, see SetTimeBudget). Stagnation restarts (see
+     * SetStagnation) keep the population from circling around the solutions that were
+     * already found.
+     *
+     * @param query         The query string.
+     * @param type          The type of fitness to use.
+     * @param generations   Number of generations to perform (0 for no limit).
+     * @param max_solutions Number of solutions after which to stop (0 for no limit).
+     * @param seconds       Time after which to stop (0 for no limit).
+     * @return              The solutions in the order that they were found.
+     */
+    std::vector<Chromosome> FindAllSolutions(const std::string& query,
+                                             Fitness::Type type,
+                                             size_t generations,
+                                             size_t max_solutions = 0,
+                                             double seconds = 0);
+    
+    /**
+     * Finds every distinct solution of the fitness' query that the search comes across.
+     *
+     * @param fitness       The fitness to use.
+     * @param generations   Number of generations to perform (0 for no limit).
+     * @param max_solutions Number of solutions after which to stop (0 for no limit).
+     * @param seconds       Time after which to stop (0 for no limit).
+     * @return              The solutions in the order that they were found.
+     */
+    std::vector<Chromosome> FindAllSolutions(const Fitness& fitness,
+                                             size_t generations,
+                                             size_t max_solutions = 0,
+                                             double seconds = 0);
+    
+    /**
+     * Returns the seconds from the start of the last FindAllSolutions at which each of
+     * its solutions was found. The gaps between them show how quickly new solutions
+     * stopped appearing.
+     *
+     * @return  The discovery time of each solution.
+     */
+    const std::vector<double>& DiscoveryTimes() const;
+    
+    /**
+     * Enables stagnation detection. When neither the best nor the mean score of the
+     * population improves for a number of generations, the population is partially
+     * restarted: the elites are kept and the rest are replaced according to the strategy.
+     *
+     * @param window            Number of generations without improvement before a restart (0 disables).
+     * @param elite_fraction    Fraction of the population (best first) that survives a restart.
+     * @param strategy          The way the rest of the population is replaced.
+     */
+    void SetStagnation(size_t window, float elite_fraction = 0.1, Restart strategy = kReseed);
+    
+    /**
+     * Returns the number of partial restarts performed by the last call to FindSolution.
+     *
+     * @return  Number of restarts.
+     */
+    size_t Restarts() const;
+    
+    /**
+     * Enables or disables duplicate elimination (enabled by default). Chromosomes that
+     * are identical to a member of the current generation are not scored again, and
+     * duplicate members are replaced with mutated or random chromosomes.
+     * Applies to queries with up to 16 letters, whose chromosomes are identified by their hash.
+     *
+     * @param enabled   True to enable duplicate elimination.
+     */
+    void SetDeduplication(bool enabled);
+    
+    /**
+     * Returns the number of fitness evaluations performed by the last call to FindSolution.
+     *
+     * @return  Number of evaluations.
+     */
+    size_t Evaluations() const;
+    
+    /**
+     * Returns the number of generations performed by the last call to FindSolution
+     * (in steady state mode, the evaluations divided by the population size).
+     *
+     * @return  Number of generations.
+     */
+    size_t Generations() const;
+    
+    /**
+     * Returns the number of fitness evaluations that the last call to FindSolution
+     * skipped since the chromosome was already scored.
+     *
+     * @return  Number of skipped evaluations.
+     */
+    size_t EvaluationsSaved() const;
+    
+    /**
+     * Returns the number of fitness evaluations of the last call to FindSolution that
+     * were resolved by the necessary conditions of the query (see Fitness::SetPreFilter).
+     *
+     * @return  Number of short-circuited evaluations.
+     */
+    size_t ShortCircuited() const;
+    
+    /**
+     * Sets the mode of the search (generational by default). In the steady state mode the
+     * number of generations passed to FindSolution is a budget of generations times the
+     * population size evaluations, the throughput is reported as evaluations per second,
+     * and stagnation detection and duplicate elimination do not apply.
+     * The island mode is a search of its own: the population is split evenly between the
+     * threads, each island holding max(2, population / threads) members (so the total is
+     * rounded to a multiple of the islands, and is at least 2 per island), and each
+     * island is bred for the number of generations (0 for no limit). Duplicate
+     * elimination, stagnation restarts, the offspring pipeline, the generation threads
+     * and the population file have no effect on it.
+     *
+     * @param mode      The mode of the search.
+     * @param threads   Number of worker threads (or islands) for the steady state and island modes (0 for all cores).
+     */
+    void SetMode(Mode mode, size_t threads = 0);
+    
+    /**
+     * Sets the number of threads that score and breed every generation of the generational
+     * mode (1 by default). The population is cut into small chunks that run on a work
+     * stealing scheduler (see WorkStealingScheduler), since the cost of scoring varies a
+     * lot between chromosomes. Crossover partners are taken from the best members as they
+     * were at the start of the generation, and duplicates are only detected against the
+     * previous generations. Has no effect with the offspring pipeline.
+     *
+     * @param threads   Number of threads (0 for all cores).
+     */
+    void SetGenerationThreads(size_t threads);
+    
+    /**
+     * Returns the totals of the work stealing scheduler over the last call to FindSolution,
+     * all zero if the generations ran on a single thread. Many steals and little idle time
+     * mean that the scheduler balanced an uneven load.
+     *
+     * @return  The totals of the scheduler.
+     */
+    WorkStealingScheduler::Statistics Scheduling() const;
+    
+    /**
+     * Sets how islands exchange members in the island mode (every 10 generations, 2
+     * members by default). The islands form a ring, and every interval each island sends
+     * copies of its best members to the next one, where they replace the worst members if
+     * they are better. The migrants are sent as a single batch, so islands on different
+     * NUMA nodes rarely touch each other's memory.
+     *
+     * @param interval  Generations between migrations (0 isolates the islands).
+     * @param migrants  Number of members that are sent.
+     */
+    void SetMigration(size_t interval, size_t migrants = 2);
+    
+    /**
+     * Sets whether the islands are placed on the NUMA nodes (enabled by default). Every
+     * island thread is pinned to a processor, the islands follow the processors node by
+     * node so that most neighbours in the ring share a node, and every island is allocated
+     * by its own thread on its own node (with libnuma if available, otherwise by first
+     * touch). When disabled the threads are not pinned and the whole population is
+     * allocated by the calling thread, on its node. Has no effect on other modes.
+     * The gain of the placement has only been measured on a single node so far, where
+     * there is none; it is expected on hosts with several nodes.
+     *
+     * @param enabled   True to place the islands.
+     */
+    void SetNumaPlacement(bool enabled);
+    
+    /**
+     * Sets whether every letter must have a different digit (not required by default).
+     * Chromosomes are always created and repaired so that leading letters and divisors
+     * are not 0, this adds distinct digits to those constraints.
+     *
+     * @param distinct  True if digits must be distinct.
+     */
+    void SetDistinctDigits(bool distinct);
+    
+    /**
+     * Sets whether FindSolution generates and compiles a scoring function for the query
+     * (see Fitness::GenerateEvaluator). Worth it for long searches of a single query,
+     * as the compilation takes a fraction of a second the first time a query is seen.
+     *
+     * @param enabled   True to generate code.
+     */
+    void SetCodeGeneration(bool enabled);
+    
+    /**
+     * Sets how FindSolution of a query uses the necessary conditions of the query before
+     * scoring a chromosome (Fitness::kExactFilter by default, see Fitness::SetPreFilter).
+     *
+     * @param filter    The use of the conditions.
+     */
+    void SetPreFilter(Fitness::Filter filter);
+    
+    /**
+     * Puts a persistent solution cache (see SolutionCache) in front of FindSolution of a
+     * query. A query that was solved before, possibly with renamed letters or swapped
+     * commutative operands, returns the verified stored solution without a search, and
+     * the solutions that are found are stored.
+     * Throws std::runtime_error if the file cannot be opened.
+     *
+     * @param path  Path of the cache file, created if needed (empty disables the cache).
+     */
+    void SetSolutionCache(const std::string& path);
+    
+    /**
+     * Keeps the population of the generational mode in a memory mapped file (see
+     * MappedPopulation) instead of in memory, for populations larger than the RAM. Every
+     * generation streams over the file in large chunks, and crossover partners are drawn
+     * from an in-memory index of the best members of the previous generation (the best
+     * fifth, up to 65536 members) instead of the sorted population. Deduplication and
+     * stagnation detection do not apply, and the peak resident set size is reported.
+     *
+     * @param path  Path of the file, created for every search and removed after it (empty keeps the population in memory).
+     *              A search fails if the file already exists.
+     */
+    void SetPopulationFile(const std::string& path);
+    
+    /**
+     * Stops the running search, which returns the best chromosome found so far.
+     * If no search is running, the next one stops at its first generation.
+     * Can be called from any thread.
+     */
+    void Cancel();
+    
+    /**
+     * Returns true if the last call to FindSolution was stopped by Cancel or by the
+     * cancellation token.
+     *
+     * @return  True if cancelled.
+     */
+    bool Cancelled() const;
+    
+    /**
+     * Sets a token that stops the searches once it is cancelled, the same way Cancel
+     * does. Unlike Cancel, the token can be shared with other threads (and algorithms)
+     * before the search starts, and a cancelled token stops every later search too.
+     *
+     * @param token     The token to watch.
+     */
+    void SetCancellationToken(const CancellationToken& token);
+    
+    /**
+     * Sets a wall clock budget for every search (none by default). The clock is checked
+     * every generation, every 64 members of a generation that is bred without the
+     * offspring pipeline and every 64 evaluations of a steady state thread, and once the
+     * budget is spent the search returns the best chromosome found so far.
+     * FindAllSolutions stops at the earlier of this budget and its own.
+     *
+     * @param seconds   Seconds that a search may take (0 for no limit).
+     */
+    void SetTimeBudget(double seconds);
+    
+    /**
+     * Returns true if the last call to FindSolution was stopped by the time budget.
+     *
+     * @return  True if the time budget was spent.
+     */
+    bool TimedOut() const;
+    
+    /**
+     * Sets a function that is called with the best chromosome and its score whenever
+     * they improve, starting with the best of the initial population, so that the best
+     * answer so far is available while the search runs. It is called on the thread of
+     * FindSolution, or in the steady state and island modes on the worker threads (one
+     * at a time), and should return quickly.
+     *
+     * @param progress  The function to call, empty to disable.
+     */
+    void SetProgressCallback(const Progress& progress);
+    
+    /**
+     * Sets whether the statistics of the search (generations, evaluations) are printed
+     * to the standard output (they are by default).
+     *
+     * @param verbose   True to print.
+     */
+    void SetVerbose(bool verbose);
+    
     /**
      * Destructor.
      */
@@ -0,0 +1,177 @@
+//
+//  MappedPopulation.cpp
+//  GeneticAlgorithm
+//
+//  Created by Maxim Vainshtein on 19/10/2026.
+//  Copyright © 2026 Maxim Vainshtein. All rights reserved.
+//
+
+#include "MappedPopulation.hpp"
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * Implementation.
+ */
+class MappedPopulation::Impl {
+public:
+    
+    /**
+     * Constructor.
+     *
+     * @param path      Path of the file.
+     * @param size      Number of members.
+     */
+    Impl(const std::string& path, size_t size);
+    
+    size_t Size() const;
+    bool Stream(size_t chunk, const std::function<bool(Member* members, size_t count)>& function);
+    
+    /**
+     * Destructor.
+     */
+    ~Impl();
+    
+private:
+    
+    /**
+     * Gives advice on the pages that hold the members [begin, end).
+     */
+    void Advise(size_t begin, size_t end, int advice);
+    
+    /**
+     * Removes the file, unless something else was put in its place since it was created.
+     */
+    void Remove();
+    
+    std::string m_path;
+    int m_file;
+    
+    ///Identity of the file that was created, so that only that file is removed.
+    dev_t m_device;
+    ino_t m_inode;
+    
+    ///The mapping of the file.
+    Member* m_members;
+    size_t m_size;
+    size_t m_bytes;
+    
+    size_t m_page;
+    
+};
+
+#pragma mark - Implementation functions
+
+MappedPopulation::Impl::Impl(const std::string& path, size_t size) :
+m_path(path),
+m_file(-1),
+m_members(NULL),
+m_size(size),
+m_bytes(std::max<size_t>(1, size) * sizeof(Member)),
+m_page(static_cast<size_t>(sysconf(_SC_PAGESIZE)))
+{
+    //An existing file is never reused, it may be anything
+    m_file = open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (m_file < 0)
+        throw std::runtime_error("Cannot create population file " + path + ": " + std::strerror(errno));
+    
+    struct stat status;
+    fstat(m_file, &status);
+    m_device = status.st_dev;
+    m_inode = status.st_ino;
+    
+    //A sparse file, the blocks are allocated as the members are written
+    if (ftruncate(m_file, m_bytes) != 0) {
+        
+        std::string error = std::strerror(errno);
+        close(m_file);
+        m_file = -1;
+        Remove();
+        throw std::runtime_error("Cannot size population file " + path + ": " + error);
+    }
+    
+    void* mapping = mmap(NULL, m_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, m_file, 0);
+    if (mapping == MAP_FAILED) {
+        
+        std::string error = std::strerror(errno);
+        close(m_file);
+        m_file = -1;
+        Remove();
+        throw std::runtime_error("Cannot map population file " + path + ": " + error);
+    }
+    
+    m_members = static_cast<Member*>(mapping);
+    
+    //Aggressive read ahead, and pages behind the reader are the first to go
+    madvise(m_members, m_bytes, MADV_SEQUENTIAL);
+}
+
+size_t MappedPopulation::Impl::Size() const { return m_size; }
+
+void MappedPopulation::Impl::Remove() {
+    
+    struct stat status;
+    if (lstat(m_path.c_str(), &status) == 0 && status.st_dev == m_device && status.st_ino == m_inode)
+        unlink(m_path.c_str());
+}
+
+void MappedPopulation::Impl::Advise(size_t begin, size_t end, int advice) {
+    
+    size_t first = (begin * sizeof(Member)) / m_page * m_page;
+    size_t last = std::min(m_bytes, (end * sizeof(Member) + m_page - 1) / m_page * m_page);
+    
+    if (last > first) madvise(reinterpret_cast<char*>(m_members) + first, last - first, advice);
+}
+
+bool MappedPopulation::Impl::Stream(size_t chunk, const std::function<bool(Member* members, size_t count)>& function) {
+    
+    chunk = std::max<size_t>(1, chunk);
+    
+    for (size_t begin = 0 ; begin < m_size ; begin += chunk) {
+        
+        size_t end = std::min(m_size, begin + chunk);
+        
+        //The next chunk is read while this one is processed
+        if (end < m_size) Advise(end, std::min(m_size, end + chunk), MADV_WILLNEED);
+        
+        bool proceed = function(m_members + begin, end - begin);
+        
+        //Shared pages keep their changes in the page cache, so the chunk can leave the resident set
+        Advise(begin, end, MADV_DONTNEED);
+        
+        if (!proceed) return false;
+    }
+    
+    return true;
+}
+
+MappedPopulation::Impl::~Impl() {
+    
+    if (m_members) munmap(m_members, m_bytes);
+    if (m_file >= 0) close(m_file);
+    
+    //The members are only good for the search that wrote them
+    Remove();
+}
+
+#pragma mark - MappedPopulation functions
+
+MappedPopulation::MappedPopulation(const std::string& path, size_t size) :
+m_pimpl(new Impl(path, size))
+{ }
+
+size_t MappedPopulation::Size() const {
+    return m_pimpl->Size();
+}
+
+bool MappedPopulation::Stream(size_t chunk, const std::function<bool(Member* members, size_t count)>& function) {
+    return m_pimpl->Stream(chunk, function);
+}
+
+MappedPopulation::~MappedPopulation() { }
@@ -0,0 +1,75 @@
+//
+//  MappedPopulation.hpp
+//  GeneticAlgorithm
+//
+//  Created by Maxim Vainshtein on 19/10/2026.
+//  Copyright © 2026 Maxim Vainshtein. All rights reserved.
+//
+
+#ifndef MappedPopulation_hpp
+#define MappedPopulation_hpp
+#include <stdlib.h>
+#include <cstdint>
+#include <string>
+#include <functional>
+#include <memory>
+
+/**
+ * A population of packed chromosomes and their scores that is kept in a memory mapped
+ * file rather than in memory, so it can be much larger than the RAM. The members are
+ * only meant to be read in order: Stream passes them a chunk at a time, asks the kernel
+ * to read the next chunk ahead and drops every chunk from the resident set once it is
+ * done (changes stay in the page cache and are written back by the kernel).
+ */
+class MappedPopulation {
+public:
+    
+    /**
+     * A packed chromosome (see Chromosome::Pack) and its score.
+     */
+    struct Member {
+        uint64_t genome;
+        uint64_t score;
+    };
+    
+    /**
+     * Constructor.
+     * Creates the file with room for the members, which start zeroed. The file must not
+     * exist yet, so that nothing else is overwritten or removed.
+     * Throws std::runtime_error if the file exists or cannot be created or mapped.
+     *
+     * @param path      Path of the file, removed by the destructor if it is still the one created.
+     * @param size      Number of members.
+     */
+    MappedPopulation(const std::string& path, size_t size);
+    
+    /**
+     * Returns the number of members.
+     *
+     * @return  Number of members.
+     */
+    size_t Size() const;
+    
+    /**
+     * Passes the members to the function in order, a chunk at a time.
+     *
+     * @param chunk     Number of members per chunk.
+     * @param function  Receives the members of a chunk and their number, returns false to stop.
+     * @return          False if the function stopped the stream.
+     */
+    bool Stream(size_t chunk, const std::function<bool(Member* members, size_t count)>& function);
+    
+    /**
+     * Destructor.
+     * Unmaps and removes the file.
+     */
+    ~MappedPopulation();
+    
+private:
+    
+    class Impl;
+    std::unique_ptr<Impl> m_pimpl;
+    
+};
+
+#endif /* MappedPopulation_hpp */
@@ -0,0 +1,300 @@
+//
+//  OffspringPipeline.cpp
+//  GeneticAlgorithm
+//
+//  Created by Maxim Vainshtein on 19/10/2026.
+//  Copyright © 2026 Maxim Vainshtein. All rights reserved.
+//
+
+#include "OffspringPipeline.hpp"
+#include "BoundedQueue.hpp"
+#include "Fitness.hpp"
+#include "Utility.hpp"
+#include <thread>
+#include <cmath>
+
+///Number of members that are handled as a single batch between stages.
+static const size_t kBatchSize = 64;
+
+/**
+ * Implementation.
+ */
+class OffspringPipeline::Impl {
+public:
+    
+    /**
+     * Constructor.
+     *
+     * @param fitness                   The fitness to use for score calculation.
+     * @param letters                   Number of letters in the chromosomes.
+     * @param population_size           Number of chromosomes in the population.
+     * @param crossover_probability     The probability to perform a crossover.
+     * @param mutation_probability      The probability to mutate each letter.
+     * @param constraints               The constraints that the offspring are repaired to satisfy.
+     * @param depth                     Number of batches that can wait between stages.
+     */
+    Impl(const Fitness& fitness,
+         size_t letters,
+         size_t population_size,
+         float crossover_probability,
+         float mutation_probability,
+         const Chromosome::Constraints& constraints,
+         size_t depth);
+    
+    /**
+     * Breeds and scores the offspring of a generation.
+     */
+    void Breed(const std::vector<scored_chromosome>& population,
+               const std::unordered_map<size_t, size_t>* known_scores,
+               const offspring_handler& handler,
+               size_t& evaluations,
+               size_t& skipped);
+    
+    /**
+     * Destructor.
+     */
+    ~Impl();
+    
+private:
+    
+    /**
+     * The random decisions that are needed to breed the offspring of a single member.
+     */
+    struct Draw {
+        uint64_t mutation_mask;
+        uint64_t mutation_values;
+        bool crossover;
+        float partner;
+        bool flip;
+    };
+    
+    /**
+     * An offspring that waits to be scored.
+     */
+    struct Offspring {
+        size_t member;
+        Chromosome chromosome;
+        size_t score;
+        bool valid;
+    };
+    
+    typedef std::vector<Draw> draw_batch;
+    typedef std::vector<Offspring> offspring_batch;
+    
+    /**
+     * Stage 1: generates batches of draws until the pipeline is stopped.
+     */
+    void GenerateDraws();
+    
+    /**
+     * Stage 3: scores batches of offspring until the pipeline is stopped.
+     */
+    void ScoreOffspring();
+    
+    /**
+     * Returns the next draw, waiting for stage 1 if needed.
+     */
+    const Draw& NextDraw();
+    
+    const Fitness& m_fitness;
+    size_t m_letters;
+    size_t m_population_size;
+    float m_crossover_probability;
+    float m_mutation_probability;
+    Chromosome::Constraints m_constraints;
+    
+    ///Connects stage 1 to stage 2.
+    BoundedQueue<draw_batch> m_draws;
+    
+    ///Connects stage 2 to stage 3.
+    BoundedQueue<offspring_batch> m_offspring;
+    
+    ///Connects stage 3 back to stage 2, holds a full generation so stage 3 never blocks.
+    BoundedQueue<offspring_batch> m_scored;
+    
+    ///The batch of draws that is being consumed and the position in it.
+    draw_batch m_current_draws;
+    size_t m_draw_index;
+    
+    std::thread m_draw_thread;
+    std::thread m_score_thread;
+};
+
+#pragma mark - Implementation functions
+
+OffspringPipeline::Impl::Impl(const Fitness& fitness,
+                              size_t letters,
+                              size_t population_size,
+                              float crossover_probability,
+                              float mutation_probability,
+                              const Chromosome::Constraints& constraints,
+                              size_t depth) :
+m_fitness(fitness),
+m_letters(letters),
+m_population_size(population_size),
+m_crossover_probability(crossover_probability),
+m_mutation_probability(mutation_probability),
+m_constraints(constraints),
+m_draws(depth),
+m_offspring(depth),
+m_scored(population_size / kBatchSize + 1),
+m_draw_index(0),
+m_draw_thread(&Impl::GenerateDraws, this),
+m_score_thread(&Impl::ScoreOffspring, this)
+{ }
+
+OffspringPipeline::Impl::~Impl() {
+    
+    m_draws.Close();
+    m_offspring.Close();
+    m_scored.Close();
+    
+    m_draw_thread.join();
+    m_score_thread.join();
+}
+
+void OffspringPipeline::Impl::GenerateDraws() {
+    
+    while (true) {
+        
+        draw_batch batch(kBatchSize);
+        for (auto& draw : batch) {
+            
+            draw.mutation_mask = 0;
+            draw.mutation_values = 0;
+            
+            for (size_t letter = 0 ; letter < m_letters ; letter++) {
+                if (utility::ThrowDice(m_mutation_probability)) {
+                    draw.mutation_mask |= static_cast<uint64_t>(0xF) << (letter * 4);
+                    draw.mutation_values |= static_cast<uint64_t>(utility::RandomInteger(10)) << (letter * 4);
+                }
+            }
+            
+            draw.crossover = utility::ThrowDice(m_crossover_probability);
+            draw.partner = utility::RandomProbability();
+            draw.flip = utility::ThrowDice(0.5);
+        }
+        
+        //Draws do not depend on the population, so they run ahead until the queue is full
+        if (!m_draws.Push(std::move(batch))) return;
+    }
+}
+
+void OffspringPipeline::Impl::ScoreOffspring() {
+    
+    offspring_batch batch;
+    while (m_offspring.Pop(batch)) {
+        
+        for (auto& offspring : batch) {
+            try {
+                
+                offspring.score = m_fitness.Score(offspring.chromosome);
+                offspring.valid = true;
+            }
+            catch (...) { offspring.valid = false; }
+        }
+        
+        if (!m_scored.Push(std::move(batch))) return;
+    }
+}
+
+const OffspringPipeline::Impl::Draw& OffspringPipeline::Impl::NextDraw() {
+    
+    if (m_draw_index == m_current_draws.size()) {
+        
+        m_draws.Pop(m_current_draws);
+        m_draw_index = 0;
+    }
+    
+    return m_current_draws[m_draw_index++];
+}
+
+void OffspringPipeline::Impl::Breed(const std::vector<scored_chromosome>& population,
+                                    const std::unordered_map<size_t, size_t>* known_scores,
+                                    const offspring_handler& handler,
+                                    size_t& evaluations,
+                                    size_t& skipped) {
+    
+    size_t pending = 0;
+    size_t partners = static_cast<size_t>(std::round(population.size() / 5.0f));
+    
+    //Scored offspring replace their members as soon as they are back, while the rest are built
+    auto merge = [&handler](const offspring_batch& batch) {
+        for (const auto& offspring : batch) {
+            if (offspring.valid) handler(offspring.member, offspring.chromosome, offspring.score);
+        }
+    };
+    
+    //Offspring are repaired, and those that are known are not scored
+    auto enqueue = [&](offspring_batch& batch, size_t member, Chromosome chromosome) {
+        
+        chromosome = Chromosome::Repair(chromosome, m_constraints);
+        
+        if (known_scores && known_scores->count(chromosome.Hash())) skipped++;
+        else batch.push_back(Offspring{ member, std::move(chromosome), 0, false });
+    };
+    
+    //Stage 2: build the offspring of each batch of members and send them to be scored
+    for (size_t start = 0 ; start < population.size() ; start += kBatchSize) {
+        
+        offspring_batch batch;
+        batch.reserve(kBatchSize * 2);
+        
+        for (size_t member = start ; member < std::min(start + kBatchSize, population.size()) ; member++) {
+            
+            const Draw& draw = NextDraw();
+            const Chromosome& parent = population[member].first;
+            
+            enqueue(batch, member, Chromosome::Mutate(parent, draw.mutation_mask, draw.mutation_values));
+            
+            if (!draw.crossover) continue;
+            
+            size_t partner = static_cast<size_t>(draw.partner * partners);
+            
+            //Avoid crossing over with self
+            if (partner == member || partner >= population.size()) continue;
+            
+            const Chromosome& first = draw.flip ? population[partner].first : parent;
+            const Chromosome& second = draw.flip ? parent : population[partner].first;
+            
+            enqueue(batch, member, Chromosome::Crossover(first, second, 0.5));
+        }
+        
+        evaluations += batch.size();
+        m_offspring.Push(std::move(batch));
+        pending++;
+        
+        offspring_batch scored;
+        while (pending && m_scored.TryPop(scored)) {
+            
+            merge(scored);
+            pending--;
+        }
+    }
+    
+    //Collect the batches that are still being scored
+    offspring_batch batch;
+    while (pending-- && m_scored.Pop(batch)) merge(batch);
+}
+
+#pragma mark - OffspringPipeline functions
+
+OffspringPipeline::OffspringPipeline(const Fitness& fitness,
+                                     size_t letters,
+                                     size_t population_size,
+                                     float crossover_probability,
+                                     float mutation_probability,
+                                     const Chromosome::Constraints& constraints,
+                                     size_t depth) :
+m_pimpl(new Impl(fitness, letters, population_size, crossover_probability, mutation_probability, constraints, depth))
+{ }
+
+void OffspringPipeline::Breed(const std::vector<scored_chromosome>& population,
+                              const std::unordered_map<size_t, size_t>* known_scores,
+                              const offspring_handler& handler,
+                              size_t& evaluations,
+                              size_t& skipped) {
+    m_pimpl->Breed(population, known_scores, handler, evaluations, skipped);
+}
+
+OffspringPipeline::~OffspringPipeline() { }
@@ -0,0 +1,95 @@
+//
+//  OffspringPipeline.hpp
+//  GeneticAlgorithm
+//
+//  Created by Maxim Vainshtein on 19/10/2026.
+//  Copyright © 2026 Maxim Vainshtein. All rights reserved.
+//
+
+#ifndef OffspringPipeline_hpp
+#define OffspringPipeline_hpp
+#include <stdlib.h>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <memory>
+#include "Chromosome.hpp"
+class Fitness;
+
+/**
+ * Breeds the offspring of a generation in three stages that run on separate threads:
+ * the random draws (mutation masks and crossover partners) are generated ahead of time,
+ * the offspring are built from the draws on the calling thread, and the offspring
+ * are scored. The stages are connected by bounded queues, so the draws of the
+ * following generations are produced while the current one is built and scored, and
+ * the scored offspring are merged while the rest of the generation is built.
+ *
+ * Building and scoring only overlap within a generation, as the next generation is
+ * bred from the merged and sorted population. With a stage per core the throughput
+ * is bounded by the scoring stage, so the pipeline pays off when building takes a
+ * large share of the time; it needs a core per stage (see kStages).
+ */
+class OffspringPipeline {
+public:
+    
+    typedef std::pair<Chromosome, size_t> scored_chromosome;
+    
+    ///Number of threads that the stages run on, including the calling thread.
+    static const size_t kStages = 3;
+    
+    /**
+     * Receives every valid offspring with its score and the index of the member it was bred for.
+     */
+    typedef std::function<void(size_t member, const Chromosome& offspring, size_t score)> offspring_handler;
+    
+    /**
+     * Constructor.
+     * Starts the threads of the draw and scoring stages.
+     *
+     * @param fitness                   The fitness to use for score calculation.
+     * @param letters                   Number of letters in the chromosomes (up to 16).
+     * @param population_size           Number of chromosomes in the population.
+     * @param crossover_probability     The probability to perform a crossover.
+     * @param mutation_probability      The probability to mutate each letter.
+     * @param constraints               The constraints that the offspring are repaired to satisfy.
+     * @param depth                     Number of batches that can wait between stages.
+     */
+    OffspringPipeline(const Fitness& fitness,
+                      size_t letters,
+                      size_t population_size,
+                      float crossover_probability,
+                      float mutation_probability,
+                      const Chromosome::Constraints& constraints,
+                      size_t depth);
+    
+    /**
+     * Breeds a mutated and possibly a crossed over offspring for each member of the
+     * sorted population, and passes the valid ones to the handler once scored.
+     * Offspring whose hash is in the known scores are not scored.
+     *
+     * @param population    The sorted population.
+     * @param known_scores  Scores of known chromosomes by hash, or NULL.
+     * @param handler       Receives the scored offspring on the calling thread.
+     * @param evaluations   Incremented by the number of scored offspring.
+     * @param skipped       Incremented by the number of known offspring.
+     */
+    void Breed(const std::vector<scored_chromosome>& population,
+               const std::unordered_map<size_t, size_t>* known_scores,
+               const offspring_handler& handler,
+               size_t& evaluations,
+               size_t& skipped);
+    
+    /**
+     * Destructor.
+     * Stops and joins the stage threads.
+     */
+    ~OffspringPipeline();
+    
+private:
+    
+    class Impl;
+    std::unique_ptr<Impl> m_pimpl;
+    
+};
+
+#endif /* OffspringPipeline_hpp */
@@ -0,0 +1,332 @@
+//
+//  Portfolio.cpp
+//  GeneticAlgorithm
+//
+//  Created by Maxim Vainshtein on 19/10/2026.
+//  Copyright © 2026 Maxim Vainshtein. All rights reserved.
+//
+
+#include "Portfolio.hpp"
+#include "GeneticAlgorithm.hpp"
+#include "CancellationToken.hpp"
+#include <iostream>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include <exception>
+
+/**
+ * Implementation.
+ */
+class Portfolio::Impl {
+public:
+    
+    /**
+     * Constructor.
+     *
+     * @param configurations    The configurations that race.
+     * @param threads           The thread budget, 0 for all cores.
+     */
+    Impl(const std::vector<Configuration>& configurations, size_t threads);
+    
+    Chromosome Solve(const std::string& query, size_t generations);
+    
+    bool Solved() const;
+    const Configuration& Winner() const;
+    double Seconds() const;
+    
+    void SetWinnerFile(const std::string& path);
+    void SetDistinctDigits(bool distinct);
+    void SetTimeBudget(double seconds);
+    void Cancel();
+    void SetVerbose(bool verbose);
+    
+private:
+    
+    /**
+     * A configuration in a race.
+     */
+    struct Racer {
+        Configuration configuration;
+        std::unique_ptr<Fitness> fitness;
+        
+        ///Generation threads of the configuration.
+        size_t threads;
+        
+        ///The result of the configuration, if it finished.
+        std::unique_ptr<Chromosome> result;
+        
+        ///The error of the configuration, if it failed.
+        std::exception_ptr error;
+    };
+    
+    /**
+     * Runs a configuration until it solves the query or is cancelled.
+     *
+     * @param racer         The configuration.
+     * @param generations   The limit of generations.
+     * @param token         Cancelled by the winner.
+     * @param winner        Index of the winner, set by the first to solve.
+     * @param index         Index of the racer.
+     * @param time_budget   The time budget of the racer in seconds, 0 for no limit.
+     */
+    void Race(Racer& racer, size_t generations, CancellationToken token, std::atomic<int>& winner, int index, double time_budget);
+    
+    ///The configurations, in the order of preference.
+    std::vector<Configuration> m_configurations;
+    
+    ///The thread budget.
+    size_t m_threads;
+    
+    ///Path of the file of the winners, empty if they are not kept.
+    std::string m_winner_file;
+    
+    bool m_distinct;
+    double m_time_budget;
+    bool m_verbose;
+    
+    ///The outcome of the last race.
+    bool m_solved;
+    Configuration m_winner;
+    double m_seconds;
+    
+    ///Cancels the current race, replaced by every race.
+    std::mutex m_token_mutex;
+    CancellationToken m_token;
+    
+};
+
+#pragma mark - Implementation functions
+
+Portfolio::Impl::Impl(const std::vector<Configuration>& configurations, size_t threads) :
+m_configurations(configurations),
+m_threads(threads ? threads : std::max(1u, std::thread::hardware_concurrency())),
+m_distinct(false),
+m_time_budget(0),
+m_verbose(true),
+m_solved(false),
+m_winner(configurations.empty() ? Configuration{ 0, 0, 0, Fitness::kEditDistance } : configurations.front()),
+m_seconds(0)
+{
+    if (configurations.empty()) throw std::invalid_argument("A portfolio needs at least one configuration");
+}
+
+void Portfolio::Impl::Race(Racer& racer, size_t generations, CancellationToken token, std::atomic<int>& winner, int index, double time_budget) {
+    
+    const Configuration& configuration = racer.configuration;
+    
+    try {
+        
+        GeneticAlgorithm algorithm(configuration.population, configuration.crossover, configuration.mutation);
+        algorithm.SetVerbose(false);
+        algorithm.SetDistinctDigits(m_distinct);
+        algorithm.SetGenerationThreads(racer.threads);
+        algorithm.SetCancellationToken(token);
+        algorithm.SetTimeBudget(time_budget);
+        
+        racer.result.reset(new Chromosome(algorithm.FindSolution(*racer.fitness, generations)));
+        
+        //The first solution wins and stops the rest
+        int none = -1;
+        if (racer.fitness->Score(*racer.result) == racer.fitness->OptimalScore() && winner.compare_exchange_strong(none, index))
+            token.Cancel();
+    }
+    catch (...) {
+        racer.error = std::current_exception();
+    }
+}
+
+Chromosome Portfolio::Impl::Solve(const std::string& query, size_t generations) {
+    
+    auto start = std::chrono::steady_clock::now();
+    std::string shape = Configuration::Shape(query);
+    
+    std::vector<Configuration> configurations(m_configurations);
+    
+    //The winner of the shape races first
+    Configuration stored = m_configurations.front();
+    if (!m_winner_file.empty() && Configuration::Load(m_winner_file, shape, stored)) {
+        
+        configurations.erase(std::remove(configurations.begin(), configurations.end(), stored), configurations.end());
+        configurations.insert(configurations.begin(), stored);
+    }
+    
+    std::vector<Racer> racers;
+    for (const auto& configuration : configurations) {
+        
+        Racer racer = { configuration, nullptr, 1, nullptr, nullptr };
+        
+        //The column carry fitness throws for queries that it does not support
+        try { racer.fitness.reset(Fitness::CreateFitness(query, configuration.type)); }
+        catch (const std::invalid_argument&) { }
+        
+        if (racer.fitness) racers.push_back(std::move(racer));
+    }
+    
+    if (racers.empty()) throw std::invalid_argument("No configuration of the portfolio supports " + query);
+    
+    //The threads that are left over go to the generations, the first racers get the remainder
+    for (size_t index = 0 ; index < racers.size() ; index++)
+        racers[index].threads = std::max<size_t>(1, m_threads / racers.size() + (index < m_threads % racers.size() ? 1 : 0));
+    
+    CancellationToken token;
+    {
+        std::lock_guard<std::mutex> lock(m_token_mutex);
+        m_token = token;
+    }
+    
+    std::atomic<int> winner(-1);
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> workers;
+    
+    //No more racers run at once than there are threads, the rest wait for a thread in order
+    size_t slots = std::min(m_threads, racers.size());
+    for (size_t slot = 0 ; slot < slots ; slot++) {
+        workers.push_back(std::thread([&, token]() {
+            
+            //The first racer always runs, so that there is a result
+            for (size_t index = next++ ; index < racers.size() && (index == 0 || !token.Cancelled()) ; index = next++) {
+                
+                //The time that is left is split evenly between the rounds of racers that are left
+                double time_budget = 0;
+                if (m_time_budget > 0) {
+                    
+                    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+                    size_t rounds = (racers.size() - index + slots - 1) / slots;
+                    
+                    time_budget = (m_time_budget - elapsed.count()) / rounds;
+                    if (time_budget <= 0 && index) break;
+                    
+                    //Never 0, which is no limit
+                    time_budget = std::max(time_budget, 1e-3);
+                }
+                
+                Race(racers[index], generations, token, winner, static_cast<int>(index), time_budget);
+            }
+        }));
+    }
+    
+    for (auto& worker : workers) worker.join();
+    
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    m_seconds = elapsed.count();
+    m_solved = winner >= 0;
+    
+    if (m_solved) {
+        
+        const Racer& racer = racers[winner];
+        m_winner = racer.configuration;
+        
+        if (m_verbose) std::cout << "Winner: " << m_winner << " (of " << racers.size() << ") in " << m_seconds * 1000 << " ms\n";
+        
+        if (!m_winner_file.empty()) Configuration::Store(m_winner_file, shape, m_winner);
+        
+        return *racer.result;
+    }
+    
+    if (m_verbose) std::cout << "No configuration solved the query in " << m_seconds * 1000 << " ms\n";
+    
+    //The fitness types score differently, so the results are compared by edit distance
+    std::unique_ptr<Fitness> yardstick(Fitness::CreateFitness(query, Fitness::kEditDistance));
+    
+    const Chromosome* best = NULL;
+    size_t best_score = 0;
+    
+    for (const auto& racer : racers) {
+        
+        if (!racer.result) continue;
+        
+        size_t score = 0;
+        try { score = yardstick->Score(*racer.result); }
+        catch (...) { }
+        
+        if (!best || score > best_score) {
+            best = racer.result.get();
+            best_score = score;
+        }
+    }
+    
+    //Every configuration failed, with the same error most likely
+    if (!best) std::rethrow_exception(racers.front().error);
+    
+    return *best;
+}
+
+bool Portfolio::Impl::Solved() const { return m_solved; }
+
+const Configuration& Portfolio::Impl::Winner() const { return m_winner; }
+
+double Portfolio::Impl::Seconds() const { return m_seconds; }
+
+void Portfolio::Impl::SetWinnerFile(const std::string& path) { m_winner_file = path; }
+
+void Portfolio::Impl::SetDistinctDigits(bool distinct) { m_distinct = distinct; }
+
+void Portfolio::Impl::SetTimeBudget(double seconds) { m_time_budget = seconds; }
+
+void Portfolio::Impl::Cancel() {
+    
+    std::lock_guard<std::mutex> lock(m_token_mutex);
+    m_token.Cancel();
+}
+
+void Portfolio::Impl::SetVerbose(bool verbose) { m_verbose = verbose; }
+
+#pragma mark - Portfolio functions
+
+Portfolio::Portfolio(const std::vector<Configuration>& configurations, size_t threads) :
+m_pimpl(new Impl(configurations, threads))
+{ }
+
+std::vector<Configuration> Portfolio::DefaultConfigurations() {
+    
+    return {
+        { 200,  1.0f, 0.1f,  Fitness::kEditDistance },
+        { 200,  1.0f, 0.1f,  Fitness::kColumnCarry },
+        { 2000, 0.7f, 0.1f,  Fitness::kEditDistance },
+        { 1000, 0.8f, 0.3f,  Fitness::kColumnCarry },
+        { 5000, 0.5f, 0.05f, Fitness::kEditDistance },
+        { 500,  0.9f, 0.2f,  Fitness::kCloseness }
+    };
+}
+
+Chromosome Portfolio::Solve(const std::string& query, size_t generations) {
+    return m_pimpl->Solve(query, generations);
+}
+
+bool Portfolio::Solved() const {
+    return m_pimpl->Solved();
+}
+
+const Configuration& Portfolio::Winner() const {
+    return m_pimpl->Winner();
+}
+
+double Portfolio::Seconds() const {
+    return m_pimpl->Seconds();
+}
+
+void Portfolio::SetWinnerFile(const std::string& path) {
+    m_pimpl->SetWinnerFile(path);
+}
+
+void Portfolio::SetDistinctDigits(bool distinct) {
+    m_pimpl->SetDistinctDigits(distinct);
+}
+
+void Portfolio::SetTimeBudget(double seconds) {
+    m_pimpl->SetTimeBudget(seconds);
+}
+
+void Portfolio::Cancel() {
+    m_pimpl->Cancel();
+}
+
+void Portfolio::SetVerbose(bool verbose) {
+    m_pimpl->SetVerbose(verbose);
+}
+
+Portfolio::~Portfolio() { }
@@ -0,0 +1,134 @@
+//
+//  Portfolio.hpp
+//  GeneticAlgorithm
+//
+//  Created by Maxim Vainshtein on 19/10/2026.
+//  Copyright © 2026 Maxim Vainshtein. All rights reserved.
+//
+
+#ifndef Portfolio_hpp
+#define Portfolio_hpp
+#include "Configuration.hpp"
+#include "Chromosome.hpp"
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <memory>
+
+/**
+ * Races several configurations of GeneticAlgorithm on the same query. Every configuration
+ * searches on its own thread at the same time, and the first one to reach the optimal
+ * score cancels the others, so a query is solved about as fast as its best configuration
+ * would solve it, without knowing in advance which one that is.
+ *
+ * The configurations share the thread budget: with fewer configurations than threads the
+ * rest of the threads are split between their generations (see
+ * GeneticAlgorithm::SetGenerationThreads), with more configurations than threads only
+ * as many race at once as there are threads, and the rest wait for one of them to give
+ * up (reach the generation limit or its share of the time budget) in the order of
+ * preference. The time that is left when a configuration starts is split evenly between
+ * the rounds of configurations that are left, so the race keeps to the time budget.
+ * Without a generation limit and a time budget a configuration only gives up when it is
+ * cancelled, so the waiting configurations never run unless the racing ones solve.
+ *
+ * The winners can be kept in a configuration file, per query shape (see
+ * Configuration::Shape). The stored winner of the shape races first, with the larger
+ * share of the threads.
+ */
+class Portfolio {
+public:
+    
+    /**
+     * Constructor.
+     *
+     * @param configurations    The configurations that race, in the order of preference.
+     * @param threads           The thread budget, 0 for all cores.
+     */
+    Portfolio(const std::vector<Configuration>& configurations = DefaultConfigurations(), size_t threads = 0);
+    
+    /**
+     * Returns configurations that differ in the size of the population, the probabilities
+     * and the fitness type, each of which solves some queries much faster than the others.
+     *
+     * @return  The configurations.
+     */
+    static std::vector<Configuration> DefaultConfigurations();
+    
+    /**
+     * Solves the query by racing the configurations. Configurations that do not support
+     * the query (the column carry fitness of a multiplication) do not race.
+     * Throws std::invalid_argument if no configuration supports the query.
+     *
+     * @param query         The query.
+     * @param generations   The limit of generations of every configuration, 0 for no limit.
+     * @return              The solution of the winner, else the result closest to a solution by edit distance.
+     */
+    Chromosome Solve(const std::string& query, size_t generations = 0);
+    
+    /**
+     * Returns true if the last call to Solve found a solution.
+     *
+     * @return  True if there is a winner.
+     */
+    bool Solved() const;
+    
+    /**
+     * Returns the configuration that found the solution of the last call to Solve.
+     *
+     * @return  The winner.
+     */
+    const Configuration& Winner() const;
+    
+    /**
+     * Returns the time that the last call to Solve took.
+     *
+     * @return  Number of seconds.
+     */
+    double Seconds() const;
+    
+    /**
+     * Keeps the winners in a configuration file, per query shape (empty disables it).
+     *
+     * @param path  Path of the file, created if needed.
+     */
+    void SetWinnerFile(const std::string& path);
+    
+    /**
+     * Sets whether every letter must have a different digit (see GeneticAlgorithm::SetDistinctDigits).
+     *
+     * @param distinct  True if digits must be distinct.
+     */
+    void SetDistinctDigits(bool distinct);
+    
+    /**
+     * Limits the time of Solve (see GeneticAlgorithm::SetTimeBudget).
+     *
+     * @param seconds   Number of seconds, 0 for no limit.
+     */
+    void SetTimeBudget(double seconds);
+    
+    /**
+     * Stops the race of the current call to Solve. Can be called from any thread.
+     */
+    void Cancel();
+    
+    /**
+     * Sets whether the winner is printed.
+     *
+     * @param verbose   True to print.
+     */
+    void SetVerbose(bool verbose);
+    
+    /**
+     * Destructor.
+     */
+    ~Portfolio();
+    
+private:
+    
+    class Impl;
+    std::unique_ptr<Impl> m_pimpl;
+    
+};
+
+#endif /* Portfolio_hpp */
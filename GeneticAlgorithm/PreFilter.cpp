@@ -0,0 +1,170 @@
+//
+//  PreFilter.cpp
+//  GeneticAlgorithm
+//
+//  Created by Maxim Vainshtein on 19/10/2026.
+//  Copyright © 2026 Maxim Vainshtein. All rights reserved.
+//
+
+#include "PreFilter.hpp"
+#include "Chromosome.hpp"
+#include <algorithm>
+
+///Longest number that the magnitude check supports, so that products fit in 64 bits.
+static const size_t kMaxDigits = 9;
+
+PreFilter::PreFilter(const std::vector<std::string>& parameters,
+                     const std::vector<char>& operations,
+                     const std::string& result,
+                     const std::string& non_zero) :
+m_result({ 0, 0, 1 }),
+m_non_zero(non_zero),
+m_magnitude(true),
+m_units(true)
+{
+    //Operands are evaluated in pairs
+    if (parameters.empty() || parameters.size() % 2 || operations.size() < parameters.size() / 2 || result.empty()) {
+        
+        m_magnitude = false;
+        m_units = false;
+        return;
+    }
+    
+    auto operand = [this](const std::string& text) {
+        
+        if (text.empty() || text.length() > kMaxDigits) m_magnitude = false;
+        
+        Operand current = { text.empty() ? '\0' : text.front(), text.empty() ? '\0' : text.back(), 1 };
+        for (size_t digit = 1 ; digit < text.length() && digit < kMaxDigits ; digit++) current.scale *= 10;
+        
+        return current;
+    };
+    
+    for (const auto& parameter : parameters) m_operands.push_back(operand(parameter));
+    m_operations.assign(operations.begin(), operations.begin() + parameters.size() / 2);
+    m_result = operand(result);
+    
+    //The last digit of a quotient depends on all the digits
+    if (std::find(m_operations.begin(), m_operations.end(), '/') != m_operations.end()) m_units = false;
+    
+    for (const auto operation : m_operations)
+        if (operation != '+' && operation != '-' && operation != '*' && operation != '/') {
+            
+            m_magnitude = false;
+            m_units = false;
+        }
+}
+
+bool PreFilter::Valid(const Chromosome& chromosome) const {
+    
+    for (const auto letter : m_non_zero)
+        if (chromosome.Value(letter) == 0) return false;
+    
+    return true;
+}
+
+bool PreFilter::Bounds(const Chromosome& chromosome, Interval& bounds) const {
+    
+    //The numbers that start with the leading digit
+    auto interval = [&chromosome](const Operand& operand, Interval& result) {
+        
+        long long leading = chromosome.Value(operand.leading);
+        if (leading < 0) return false;
+        
+        result = { leading * operand.scale, leading * operand.scale + operand.scale - 1 };
+        return true;
+    };
+    
+    bounds = { 0, 0 };
+    
+    for (size_t pair = 0 ; pair < m_operations.size() ; pair++) {
+        
+        Interval first, second;
+        if (!interval(m_operands[2 * pair], first) || !interval(m_operands[2 * pair + 1], second)) return false;
+        
+        switch (m_operations[pair]) {
+            case '+':
+                bounds.low += first.low + second.low;
+                bounds.high += first.high + second.high;
+                break;
+                
+            case '-':
+                bounds.low += first.low - second.high;
+                bounds.high += first.high - second.low;
+                break;
+                
+            case '*':
+                bounds.low += first.low * second.low;
+                bounds.high += first.high * second.high;
+                break;
+                
+            case '/':
+                //A single letter divisor of 0 is an invalid chromosome
+                if (second.high == 0) return false;
+                
+                bounds.low += first.low / second.high;
+                bounds.high += first.high / std::max(1LL, second.low);
+                break;
+        }
+    }
+    
+    return true;
+}
+
+bool PreFilter::LengthMismatch(const Chromosome& chromosome) const {
+    
+    if (!m_magnitude || !Valid(chromosome)) return false;
+    
+    Interval bounds;
+    if (!Bounds(chromosome, bounds)) return false;
+    
+    //Negative values are rejected by the full evaluation
+    if (bounds.low < 0) return false;
+    
+    //Numbers with as many digits as the result
+    long long shortest = (m_result.scale > 1) ? m_result.scale : 0;
+    long long longest = m_result.scale * 10 - 1;
+    
+    return bounds.high < shortest || bounds.low > longest;
+}
+
+bool PreFilter::Feasible(const Chromosome& chromosome) const {
+    
+    if (!Valid(chromosome)) return true;
+    
+    if (m_units) {
+        
+        long long units = 0;
+        
+        for (size_t pair = 0 ; pair < m_operations.size() ; pair++) {
+            
+            long long first = chromosome.Value(m_operands[2 * pair].last);
+            long long second = chromosome.Value(m_operands[2 * pair + 1].last);
+            
+            switch (m_operations[pair]) {
+                case '+': units += first + second; break;
+                case '-': units += first - second; break;
+                case '*': units += first * second; break;
+            }
+        }
+        
+        if (((units % 10) + 10) % 10 != chromosome.Value(m_result.last)) return false;
+    }
+    
+    if (m_magnitude) {
+        
+        Interval bounds;
+        long long leading = chromosome.Value(m_result.leading);
+        
+        //The numbers that start with the leading digit of the result
+        if (Bounds(chromosome, bounds) && leading >= 0) {
+            
+            long long low = leading * m_result.scale;
+            long long high = low + m_result.scale - 1;
+            
+            if (bounds.high < low || bounds.low > high) return false;
+        }
+    }
+    
+    return true;
+}
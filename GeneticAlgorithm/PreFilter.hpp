@@ -0,0 +1,123 @@
+//
+//  PreFilter.hpp
+//  GeneticAlgorithm
+//
+//  Created by Maxim Vainshtein on 19/10/2026.
+//  Copyright © 2026 Maxim Vainshtein. All rights reserved.
+//
+
+#ifndef PreFilter_hpp
+#define PreFilter_hpp
+#include <stdlib.h>
+#include <string>
+#include <vector>
+class Chromosome;
+
+/**
+ * Necessary conditions for a chromosome to solve a query, that only look at a few
+ * letters and so are much cheaper than decoding the numbers and encoding the result:
+ *
+ * - Magnitude: the leading digit of every number bounds it (a 4 letter number that
+ *   starts with 3 is in 3000...3999), so the left hand side is bounded by interval
+ *   arithmetic over the operations. A solution has its value within the bounds of the
+ *   result, and if the bounds of the left hand side are outside the numbers with as many
+ *   digits as the result, no encoding of it has the length of the result.
+ * - Units column: the last digit of the left hand side only depends on the last digits
+ *   of the operands (for additions, subtractions and multiplications), and a solution
+ *   ends with the last digit of the result.
+ *
+ * The checks are derived once from the parsed query. Checks that do not apply to the
+ * query (divisions for the units column, numbers too long for 64 bits for the magnitude)
+ * always pass, and so do invalid chromosomes (a 0 in a letter that cannot be 0), so that
+ * the full evaluation rejects them as before.
+ */
+class PreFilter {
+public:
+    
+    /**
+     * Constructor.
+     * The operations are taken one per pair of operands, as Fitness does.
+     *
+     * @param parameters    The operands of the query.
+     * @param operations    The operators of the query ('+', '-', '*' or '/').
+     * @param result        The result of the query.
+     * @param non_zero      The letters that cannot be 0 in a valid chromosome.
+     */
+    PreFilter(const std::vector<std::string>& parameters,
+              const std::vector<char>& operations,
+              const std::string& result,
+              const std::string& non_zero);
+    
+    /**
+     * Returns true if the left hand side certainly has a different number of digits than
+     * the result. False if the bounds are not certain, or if the chromosome is invalid.
+     *
+     * @param chromosome    The chromosome to check.
+     * @return              True if the length of the result cannot be matched.
+     */
+    bool LengthMismatch(const Chromosome& chromosome) const;
+    
+    /**
+     * Returns false if the chromosome certainly does not solve the query, by the
+     * magnitude or by the units column.
+     *
+     * @param chromosome    The chromosome to check.
+     * @return              False if the chromosome is not a solution.
+     */
+    bool Feasible(const Chromosome& chromosome) const;
+    
+private:
+    
+    /**
+     * Bounds of a value.
+     */
+    struct Interval {
+        long long low;
+        long long high;
+    };
+    
+    /**
+     * An operand as the magnitude check sees it.
+     */
+    struct Operand {
+        char leading;
+        char last;
+        
+        ///10 to the power of the length minus 1.
+        long long scale;
+    };
+    
+    /**
+     * Returns true if no letter that cannot be 0 is 0.
+     *
+     * @param chromosome    The chromosome to check.
+     * @return              True if the chromosome is valid.
+     */
+    bool Valid(const Chromosome& chromosome) const;
+    
+    /**
+     * Bounds the left hand side by the leading digits.
+     *
+     * @param chromosome    The chromosome to check.
+     * @param bounds        Receives the bounds.
+     * @return              False if the bounds cannot be found (a division by 0).
+     */
+    bool Bounds(const Chromosome& chromosome, Interval& bounds) const;
+    
+    ///The operands, and the operator of each pair.
+    std::vector<Operand> m_operands;
+    std::vector<char> m_operations;
+    
+    ///The result as an operand.
+    Operand m_result;
+    
+    ///The letters that cannot be 0.
+    std::string m_non_zero;
+    
+    ///True if the magnitude and the units column checks apply.
+    bool m_magnitude;
+    bool m_units;
+    
+};
+
+#endif /* PreFilter_hpp */
@@ -0,0 +1,116 @@
+//
+//  Protocol.cpp
+//  GeneticAlgorithm
+//
+//  Created by Maxim Vainshtein on 19/10/2026.
+//  Copyright © 2026 Maxim Vainshtein. All rights reserved.
+//
+
+#include "Protocol.hpp"
+#include <sstream>
+#include <stdexcept>
+#include <cerrno>
+#include <cstdint>
+#include <sys/types.h>
+#include <sys/socket.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+/**
+ * Reads exactly length bytes, retrying on partial reads.
+ */
+static bool ReadAll(int socket, char* buffer, size_t length) {
+
+    while (length) {
+
+        ssize_t count = recv(socket, buffer, length, 0);
+
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) return false;
+
+        buffer += count;
+        length -= count;
+    }
+
+    return true;
+}
+
+/**
+ * Writes exactly length bytes, retrying on partial writes.
+ */
+static bool WriteAll(int socket, const char* buffer, size_t length) {
+
+    while (length) {
+
+        //A client that hung up should not kill the server with SIGPIPE
+        ssize_t count = send(socket, buffer, length, MSG_NOSIGNAL);
+
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) return false;
+
+        buffer += count;
+        length -= count;
+    }
+
+    return true;
+}
+
+bool protocol::ReadMessage(int socket, std::string& message) {
+
+    unsigned char header[4];
+    if (!ReadAll(socket, reinterpret_cast<char*>(header), sizeof(header))) return false;
+
+    uint32_t length = (uint32_t(header[0]) << 24) | (uint32_t(header[1]) << 16) | (uint32_t(header[2]) << 8) | uint32_t(header[3]);
+    if (length > kMaxMessage) return false;
+
+    message.resize(length);
+    return length == 0 || ReadAll(socket, &message[0], length);
+}
+
+bool protocol::WriteMessage(int socket, const std::string& message) {
+
+    uint32_t length = static_cast<uint32_t>(message.size());
+    unsigned char header[4] = {
+        static_cast<unsigned char>(length >> 24),
+        static_cast<unsigned char>(length >> 16),
+        static_cast<unsigned char>(length >> 8),
+        static_cast<unsigned char>(length)
+    };
+
+    //A single buffer so that small messages go out in a single packet
+    std::string buffer(reinterpret_cast<const char*>(header), sizeof(header));
+    buffer += message;
+
+    return WriteAll(socket, buffer.data(), buffer.size());
+}
+
+protocol::Request protocol::ParseRequest(const std::string& message) {
+
+    std::istringstream stream(message);
+
+    Request request;
+    request.deadline_ms = 0;
+
+    if (!(stream >> request.query >> request.population >> request.crossover >> request.mutation >> request.type >> request.generations))
+        throw std::invalid_argument("Expected: query population crossover mutation type generations [deadline_ms]");
+
+    //Optional
+    if (!(stream >> request.deadline_ms)) request.deadline_ms = 0;
+
+    if (request.population == 0)
+        throw std::invalid_argument("Population must not be empty");
+
+    return request;
+}
+
+std::string protocol::FormatRequest(const Request& request) {
+
+    std::ostringstream stream;
+
+    stream << request.query << " " << request.population << " " << request.crossover << " "
+    << request.mutation << " " << request.type << " " << request.generations << " " << request.deadline_ms;
+
+    return stream.str();
+}
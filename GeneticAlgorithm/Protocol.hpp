@@ -0,0 +1,84 @@
+//
+//  Protocol.hpp
+//  GeneticAlgorithm
+//
+//  Created by Maxim Vainshtein on 19/10/2026.
+//  Copyright © 2026 Maxim Vainshtein. All rights reserved.
+//
+
+#ifndef Protocol_hpp
+#define Protocol_hpp
+#include <stdlib.h>
+#include <string>
+
+/**
+ * The protocol between the solver server and its clients. Every message is a 4 byte
+ * big endian length followed by that many bytes of text.
+ *
+ * A request is a line of space separated fields:
+ *      query population crossover mutation type generations [deadline_ms]
+ * such as "SEND+MORE=MONEY 200 1 0.1 1 0 500". A deadline of 0 (or none) means no deadline.
+ * While a request is running the client may send "cancel" to stop it.
+ *
+ * A response is a status followed by the chromosome or an error message:
+ *      solved   - the chromosome is a solution.
+ *      best     - the generation limit was reached, the chromosome is the best found.
+ *      deadline - the deadline passed, the chromosome is the best found.
+ *      cancelled - the client cancelled, the chromosome is the best found.
+ *      error    - the request could not be served.
+ */
+namespace protocol {
+
+    ///Largest message that is accepted.
+    static const size_t kMaxMessage = 1 << 16;
+
+    /**
+     * Parameters of a request.
+     */
+    struct Request {
+        std::string query;
+        size_t population;
+        float crossover;
+        float mutation;
+        int type;
+        size_t generations;
+        size_t deadline_ms;
+    };
+
+    /**
+     * Reads a message from the socket, blocking until it is complete.
+     *
+     * @param socket    The connected socket.
+     * @param message   Receives the message.
+     * @return          False if the connection was closed or the message is malformed.
+     */
+    bool ReadMessage(int socket, std::string& message);
+
+    /**
+     * Writes a message to the socket.
+     *
+     * @param socket    The connected socket.
+     * @param message   The message to write.
+     * @return          False if the connection was closed.
+     */
+    bool WriteMessage(int socket, const std::string& message);
+
+    /**
+     * Parses the text of a request, throws std::invalid_argument if it is malformed.
+     *
+     * @param message   The text of the request.
+     * @return          The parsed request.
+     */
+    Request ParseRequest(const std::string& message);
+
+    /**
+     * Formats a request as text.
+     *
+     * @param request   The request to format.
+     * @return          The text of the request.
+     */
+    std::string FormatRequest(const Request& request);
+
+}
+
+#endif /* Protocol_hpp */
@@ -0,0 +1,435 @@
+//
+//  Server.cpp
+//  GeneticAlgorithm
+//
+//  Created by Maxim Vainshtein on 19/10/2026.
+//  Copyright © 2026 Maxim Vainshtein. All rights reserved.
+//
+
+#include "Server.hpp"
+#include "Protocol.hpp"
+#include "BoundedQueue.hpp"
+#include "GeneticAlgorithm.hpp"
+#include "Fitness.hpp"
+#include "Chromosome.hpp"
+#include <map>
+#include <set>
+#include <list>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <sstream>
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+///Interval between the checks of the running requests for cancellations, and of the idle connections for requests.
+static const std::chrono::milliseconds kWatchInterval(2);
+
+///The cancel message, with its length.
+static const char kCancelFrame[] = { 0, 0, 0, 6, 'c', 'a', 'n', 'c', 'e', 'l' };
+
+/**
+ * Removes the socket file at the path, if there is one.
+ *
+ * @param path  The path of the socket.
+ * @return      False if something other than a socket is at the path, which is left as is.
+ */
+static bool RemoveSocket(const std::string& path) {
+
+    struct stat status;
+    if (lstat(path.c_str(), &status) != 0) return errno == ENOENT;
+    if (!S_ISSOCK(status.st_mode)) return false;
+
+    unlink(path.c_str());
+    return true;
+}
+
+/**
+ * Implementation.
+ */
+class Server::Impl {
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param path              Path of the socket.
+     * @param workers           Number of worker threads.
+     * @param code_generation   True to generate the scoring functions.
+     */
+    Impl(const std::string& path, size_t workers, bool code_generation);
+
+    void Run();
+    void Stop();
+
+    /**
+     * Destructor.
+     */
+    ~Impl();
+
+private:
+
+    /**
+     * A request that is being searched.
+     */
+    struct Active {
+        int socket;
+        GeneticAlgorithm* algorithm;
+
+        ///The status of the response if the search was stopped early, empty if not.
+        std::string stopped;
+    };
+
+    /**
+     * Serves a request of every connection from the queue.
+     */
+    void Worker();
+
+    /**
+     * Serves the next request of a connection.
+     *
+     * @param socket    The connected socket.
+     * @return          False if the connection was closed.
+     */
+    bool Serve(int socket);
+
+    /**
+     * Searches a request and returns the response.
+     *
+     * @param socket    The connected socket (watched for cancellations).
+     * @param message   The text of the request.
+     */
+    std::string Solve(int socket, const std::string& message);
+
+    /**
+     * Returns the shared fitness of the query, creating it on first use.
+     */
+    std::shared_ptr<Fitness> FitnessOf(const std::string& query, Fitness::Type type);
+
+    /**
+     * Stops the running requests whose client cancelled, and queues the idle connections
+     * that sent a request.
+     */
+    void Watch();
+
+    ///Path of the socket.
+    std::string m_path;
+
+    ///The listening socket, -1 if not listening.
+    std::atomic<int> m_socket;
+
+    ///True once Stop is called.
+    std::atomic<bool> m_stopped;
+
+    size_t m_workers;
+    bool m_code_generation;
+
+    ///Connections with a request that wait for a worker.
+    BoundedQueue<int> m_connections;
+
+    ///The fitness of every query that was requested, by query and type.
+    std::map<std::pair<std::string, int>, std::shared_ptr<Fitness>> m_fitnesses;
+    std::mutex m_fitnesses_mutex;
+
+    ///The running requests.
+    std::list<Active> m_active;
+    
+    ///The connections that are being served.
+    std::set<int> m_open;
+    
+    ///The connections that wait for their next request, without a worker.
+    std::set<int> m_idle;
+    
+    ///Guards m_active, m_open and m_idle.
+    std::mutex m_active_mutex;
+
+};
+
+#pragma mark - Implementation functions
+
+Server::Impl::Impl(const std::string& path, size_t workers, bool code_generation) :
+m_path(path),
+m_socket(-1),
+m_stopped(false),
+m_workers(workers ? workers : 1),
+m_code_generation(code_generation),
+m_connections(workers ? workers : 1)
+{ }
+
+void Server::Impl::Run() {
+
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+
+    if (m_path.size() >= sizeof(address.sun_path))
+        throw std::runtime_error("Socket path is too long: " + m_path);
+
+    std::strncpy(address.sun_path, m_path.c_str(), sizeof(address.sun_path) - 1);
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0)
+        throw std::runtime_error(std::string("Cannot create socket: ") + std::strerror(errno));
+
+    //A socket file that was left by an earlier server
+    if (!RemoveSocket(m_path)) {
+
+        close(listener);
+        throw std::runtime_error("Cannot listen on " + m_path + ": the path exists and is not a socket");
+    }
+
+    if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, 128) != 0) {
+
+        std::string error = std::strerror(errno);
+        close(listener);
+        throw std::runtime_error("Cannot listen on " + m_path + ": " + error);
+    }
+
+    m_socket = listener;
+
+    std::vector<std::thread> workers;
+    for (size_t index = 0 ; index < m_workers ; index++)
+        workers.emplace_back(&Impl::Worker, this);
+
+    std::thread watcher(&Impl::Watch, this);
+
+    while (!m_stopped) {
+
+        int connection = accept(listener, NULL, NULL);
+
+        if (connection < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            break;
+        }
+
+        //Idle until the watcher sees its first request, so that an idle client never holds a worker
+        std::lock_guard<std::mutex> lock(m_active_mutex);
+        if (m_stopped) close(connection);
+        else m_idle.insert(connection);
+    }
+
+    Stop();
+    m_connections.Close();
+
+    for (std::thread& worker : workers) worker.join();
+    watcher.join();
+
+    for (int connection : m_idle) close(connection);
+    m_idle.clear();
+
+    m_socket = -1;
+    close(listener);
+    RemoveSocket(m_path);
+}
+
+void Server::Impl::Stop() {
+
+    m_stopped = true;
+
+    //Releases the accept in Run
+    int listener = m_socket;
+    if (listener >= 0) shutdown(listener, SHUT_RDWR);
+
+    //Releases the workers that wait for requests, running requests are cancelled by the watcher
+    std::lock_guard<std::mutex> lock(m_active_mutex);
+    for (int connection : m_open) shutdown(connection, SHUT_RD);
+}
+
+void Server::Impl::Worker() {
+
+    int connection;
+    while (m_connections.Pop(connection)) {
+
+        {
+            std::lock_guard<std::mutex> lock(m_active_mutex);
+            m_open.insert(connection);
+        }
+
+        bool open = !m_stopped && Serve(connection);
+
+        //The connection goes back to the watcher until its next request
+        std::lock_guard<std::mutex> lock(m_active_mutex);
+        m_open.erase(connection);
+
+        if (open && !m_stopped) m_idle.insert(connection);
+        else close(connection);
+    }
+}
+
+bool Server::Impl::Serve(int socket) {
+
+    std::string message;
+    if (!protocol::ReadMessage(socket, message)) return false;
+
+    //A late cancellation of a request that already finished
+    if (message == "cancel") return true;
+
+    return protocol::WriteMessage(socket, Solve(socket, message));
+}
+
+std::string Server::Impl::Solve(int socket, const std::string& message) {
+
+    protocol::Request request;
+    std::shared_ptr<Fitness> fitness;
+
+    try {
+
+        request = protocol::ParseRequest(message);
+        fitness = FitnessOf(request.query, static_cast<Fitness::Type>(request.type));
+    }
+    catch (const std::exception& exception) { return std::string("error ") + exception.what(); }
+
+    GeneticAlgorithm algorithm(request.population, request.crossover, request.mutation);
+    algorithm.SetVerbose(false);
+    
+    //The search checks its own deadline, much more often than the watcher could
+    algorithm.SetTimeBudget(request.deadline_ms / 1000.0);
+
+    //Register for the watcher, which may cancel the search from now on
+    std::list<Active>::iterator active;
+    {
+        std::lock_guard<std::mutex> lock(m_active_mutex);
+
+        Active entry = { socket, &algorithm, std::string() };
+        active = m_active.insert(m_active.end(), entry);
+    }
+
+    //Unregisters the request however the search ends, before the algorithm is destroyed
+    struct Registration {
+        std::mutex& mutex;
+        std::list<Active>& list;
+        std::list<Active>::iterator active;
+
+        ~Registration() {
+
+            std::lock_guard<std::mutex> lock(mutex);
+            list.erase(active);
+        }
+    } registration = { m_active_mutex, m_active, active };
+
+    std::ostringstream response;
+
+    try {
+
+        Chromosome result = algorithm.FindSolution(*fitness, request.generations);
+
+        std::string stopped;
+        {
+            std::lock_guard<std::mutex> lock(m_active_mutex);
+            stopped = active->stopped;
+        }
+
+        if (fitness->Score(result) == fitness->OptimalScore()) response << "solved ";
+        else if (!stopped.empty()) response << stopped << " ";
+        else if (algorithm.TimedOut()) response << "deadline ";
+        else response << "best ";
+
+        response << result;
+    }
+    catch (const std::exception& exception) {
+
+        response.str("");
+        response << "error " << exception.what();
+    }
+
+    return response.str();
+}
+
+std::shared_ptr<Fitness> Server::Impl::FitnessOf(const std::string& query, Fitness::Type type) {
+
+    auto key = std::make_pair(query, static_cast<int>(type));
+
+    {
+        std::lock_guard<std::mutex> lock(m_fitnesses_mutex);
+
+        auto cached = m_fitnesses.find(key);
+        if (cached != m_fitnesses.end()) return cached->second;
+    }
+
+    //Created outside of the lock, the compiler may take a while
+    std::shared_ptr<Fitness> fitness(Fitness::CreateFitness(query, type));
+    if (!fitness) throw std::invalid_argument("Unknown fitness type");
+
+    if (m_code_generation) fitness->GenerateEvaluator();
+
+    //The first of concurrent creations is kept
+    std::lock_guard<std::mutex> lock(m_fitnesses_mutex);
+    return m_fitnesses.insert(std::make_pair(key, fitness)).first->second;
+}
+
+void Server::Impl::Watch() {
+
+    //Runs until the workers are done, so that running requests are still stopped after Stop
+    while (true) {
+
+        std::this_thread::sleep_for(kWatchInterval);
+
+        std::lock_guard<std::mutex> lock(m_active_mutex);
+
+        if (m_stopped && m_open.empty()) return;
+
+        //Idle connections with a request (or a hangup) are queued, those that do not fit wait for the next check
+        if (!m_stopped && !m_idle.empty()) {
+
+            std::vector<pollfd> idle;
+            for (int connection : m_idle) idle.push_back({ connection, POLLIN, 0 });
+
+            if (poll(idle.data(), idle.size(), 0) > 0) {
+
+                for (const auto& descriptor : idle)
+                    if (descriptor.revents && m_connections.TryPush(descriptor.fd)) m_idle.erase(descriptor.fd);
+            }
+        }
+
+        for (Active& active : m_active) {
+
+            if (!active.stopped.empty()) continue;
+
+            //The client only writes during a search to cancel it (or by hanging up)
+            pollfd descriptor = { active.socket, POLLIN, 0 };
+            if (poll(&descriptor, 1, 0) <= 0) continue;
+
+            //Only peeked, so that a partial message never blocks and a pipelined request is left to Serve
+            char frame[sizeof(kCancelFrame)];
+            ssize_t peeked = recv(active.socket, frame, sizeof(frame), MSG_PEEK | MSG_DONTWAIT);
+
+            bool hung_up = peeked == 0 || (peeked < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) ||
+                           (descriptor.revents & (POLLHUP | POLLERR));
+            bool cancelled = peeked == sizeof(frame) && std::memcmp(frame, kCancelFrame, sizeof(frame)) == 0;
+
+            if (!hung_up && !cancelled) continue;
+
+            //The whole message is already there
+            if (cancelled) recv(active.socket, frame, sizeof(frame), MSG_DONTWAIT);
+
+            active.stopped = "cancelled";
+            active.algorithm->Cancel();
+        }
+    }
+}
+
+Server::Impl::~Impl() { }
+
+#pragma mark - Server functions
+
+Server::Server(const std::string& path, size_t workers, bool code_generation) :
+m_pimpl(new Impl(path, workers, code_generation))
+{ }
+
+void Server::Run() {
+    m_pimpl->Run();
+}
+
+void Server::Stop() {
+    m_pimpl->Stop();
+}
+
+Server::~Server() { }
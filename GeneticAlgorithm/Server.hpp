@@ -0,0 +1,67 @@
+//
+//  Server.hpp
+//  GeneticAlgorithm
+//
+//  Created by Maxim Vainshtein on 19/10/2026.
+//  Copyright © 2026 Maxim Vainshtein. All rights reserved.
+//
+
+#ifndef Server_hpp
+#define Server_hpp
+#include <stdlib.h>
+#include <string>
+#include <memory>
+
+/**
+ * A long lived solver that serves requests over a Unix domain socket (see Protocol.hpp
+ * for the messages). The worker threads are started once and the fitness of every query
+ * is created (and optionally compiled) once and kept for the following requests, so a
+ * request only pays for its search.
+ *
+ * Requests are served concurrently, one per worker thread. A connection only holds a
+ * worker while one of its requests is read and searched, between requests it waits
+ * without one, so idle clients never keep the others waiting. A request stops early when
+ * its deadline passes, when the client sends "cancel" or when the client hangs up.
+ * A request that a client sends during a search is served once the search is done, so
+ * a cancellation only applies if it comes right after the request being searched.
+ */
+class Server {
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param path              Path of the Unix domain socket to listen on. A socket that exists
+     *                          there is replaced, Run refuses any other kind of file.
+     * @param workers           Number of requests that are served at the same time.
+     * @param code_generation   True to generate the scoring function of every query (see GeneticAlgorithm::SetCodeGeneration).
+     */
+    Server(const std::string& path, size_t workers = 4, bool code_generation = false);
+
+    /**
+     * Accepts connections until Stop is called, then removes the socket file.
+     * Throws std::runtime_error if the socket cannot be created, or if something other
+     * than a socket is at its path.
+     */
+    void Run();
+
+    /**
+     * Stops accepting connections and cancels the running requests (their clients still
+     * receive the best chromosome found). Run returns once the workers are done.
+     * Can be called from any thread.
+     */
+    void Stop();
+
+    /**
+     * Destructor.
+     */
+    ~Server();
+
+private:
+
+    class Impl;
+    std::unique_ptr<Impl> m_pimpl;
+
+};
+
+#endif /* Server_hpp */
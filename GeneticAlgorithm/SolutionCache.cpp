@@ -0,0 +1,322 @@
+//
+//  SolutionCache.cpp
+//  GeneticAlgorithm
+//
+//  Created by Maxim Vainshtein on 19/10/2026.
+//  Copyright © 2026 Maxim Vainshtein. All rights reserved.
+//
+
+#include "SolutionCache.hpp"
+#include <vector>
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+
+///Identifies a cache file (and its layout version).
+static const uint64_t kMagic = 0x314843414C4F5347ULL;
+
+///Maximal number of letters, as a solution is stored packed.
+static const size_t kMaxLetters = 16;
+
+///Maximal number of commutative pairs whose orders are all tried, the rest keep their order.
+static const size_t kMaxSwappedPairs = 8;
+
+///Number of slots that are probed before the home slot of a key is replaced.
+static const size_t kMaxProbes = 16;
+
+/**
+ * The start of the file.
+ */
+struct Header {
+    uint64_t magic;
+    uint64_t capacity;
+};
+
+/**
+ * A stored solution, a key of 0 marks an empty slot.
+ */
+struct Slot {
+    uint64_t key;
+    uint64_t genome;
+};
+
+static bool IsOperator(char character) {
+    return character == '+' || character == '-' || character == '*' || character == '/' || character == '=';
+}
+
+/**
+ * Stable 64 bit hash of the canonical query (FNV-1a), never 0.
+ */
+static uint64_t KeyOf(const std::string& canonical) {
+
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (char character : canonical) {
+        hash ^= static_cast<unsigned char>(character);
+        hash *= 0x100000001b3ULL;
+    }
+
+    return hash ? hash : 1;
+}
+
+/**
+ * Relabels the letters of the query in the order that they first appear.
+ */
+static std::string Relabel(const std::string& query, std::string& letters) {
+
+    std::string relabelled(query);
+    letters.clear();
+
+    for (char& character : relabelled) {
+
+        if (IsOperator(character)) continue;
+
+        size_t label = letters.find(character);
+        if (label == std::string::npos) {
+            label = letters.size();
+            letters.push_back(character);
+        }
+
+        character = static_cast<char>('A' + label);
+    }
+
+    return relabelled;
+}
+
+/**
+ * Implementation.
+ */
+class SolutionCache::Impl {
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param path      Path of the cache file.
+     * @param capacity  Number of slots of a new file.
+     */
+    Impl(const std::string& path, size_t capacity);
+
+    bool Find(const std::string& query, Chromosome& solution) const;
+    void Store(const std::string& query, const Chromosome& solution);
+
+    /**
+     * Destructor.
+     */
+    ~Impl();
+
+private:
+
+    ///The descriptor of the file.
+    int m_file;
+
+    ///The mapping of the file.
+    void* m_mapping;
+    size_t m_size;
+
+    ///The slots in the mapping.
+    Slot* m_slots;
+    uint64_t m_mask;
+
+};
+
+#pragma mark - Implementation functions
+
+SolutionCache::Impl::Impl(const std::string& path, size_t capacity) :
+m_file(-1),
+m_mapping(MAP_FAILED),
+m_size(0),
+m_slots(NULL),
+m_mask(0)
+{
+    m_file = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (m_file < 0)
+        throw std::runtime_error("Cannot open solution cache " + path + ": " + std::strerror(errno));
+
+    //The first process to open the file creates its layout
+    flock(m_file, LOCK_EX);
+
+    struct stat status;
+    fstat(m_file, &status);
+
+    if (status.st_size == 0) {
+
+        size_t slots = 1;
+        while (slots < capacity) slots <<= 1;
+
+        Header header = { kMagic, slots };
+        if (ftruncate(m_file, sizeof(Header) + slots * sizeof(Slot)) != 0 ||
+            pwrite(m_file, &header, sizeof(header), 0) != sizeof(header)) {
+
+            flock(m_file, LOCK_UN);
+            close(m_file);
+            throw std::runtime_error("Cannot create solution cache " + path);
+        }
+
+        fstat(m_file, &status);
+    }
+
+    flock(m_file, LOCK_UN);
+
+    Header header;
+    if (pread(m_file, &header, sizeof(header), 0) != sizeof(header) || header.magic != kMagic ||
+        header.capacity == 0 || (header.capacity & (header.capacity - 1)) ||
+        static_cast<uint64_t>(status.st_size) < sizeof(Header) + header.capacity * sizeof(Slot)) {
+
+        close(m_file);
+        throw std::runtime_error(path + " is not a solution cache");
+    }
+
+    m_size = status.st_size;
+    m_mapping = mmap(NULL, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_file, 0);
+
+    if (m_mapping == MAP_FAILED) {
+
+        close(m_file);
+        throw std::runtime_error("Cannot map solution cache " + path + ": " + std::strerror(errno));
+    }
+
+    m_slots = reinterpret_cast<Slot*>(static_cast<char*>(m_mapping) + sizeof(Header));
+    m_mask = header.capacity - 1;
+}
+
+bool SolutionCache::Impl::Find(const std::string& query, Chromosome& solution) const {
+
+    std::string letters;
+    std::string canonical = Canonicalize(query, &letters);
+    if (canonical.empty()) return false;
+
+    uint64_t key = KeyOf(canonical);
+
+    for (size_t probe = 0 ; probe < kMaxProbes ; probe++) {
+
+        const Slot& slot = m_slots[(key + probe) & m_mask];
+
+        //The key is published after the genome, see Store
+        uint64_t stored = __atomic_load_n(&slot.key, __ATOMIC_ACQUIRE);
+
+        if (stored == 0) return false;
+        if (stored != key) continue;
+
+        uint64_t genome = __atomic_load_n(&slot.genome, __ATOMIC_RELAXED);
+
+        //Back to the letters of the query, the canonical label of letters[i] is the i'th value
+        Chromosome::elements interpretations;
+        for (size_t label = 0 ; label < letters.size() ; label++)
+            interpretations[letters[label]] = static_cast<short>((genome >> (4 * label)) & 0xF);
+
+        solution = Chromosome(interpretations);
+        return true;
+    }
+
+    return false;
+}
+
+void SolutionCache::Impl::Store(const std::string& query, const Chromosome& solution) {
+
+    std::string letters;
+    std::string canonical = Canonicalize(query, &letters);
+    if (canonical.empty()) return;
+
+    uint64_t key = KeyOf(canonical);
+
+    uint64_t genome = 0;
+    for (size_t label = 0 ; label < letters.size() ; label++)
+        genome |= static_cast<uint64_t>(solution.Value(letters[label]) & 0xF) << (4 * label);
+
+    flock(m_file, LOCK_EX);
+
+    //The slot of the key, else the first empty one, else the home slot is replaced
+    Slot* target = &m_slots[key & m_mask];
+    for (size_t probe = 0 ; probe < kMaxProbes ; probe++) {
+
+        Slot* slot = &m_slots[(key + probe) & m_mask];
+        if (slot->key == key || slot->key == 0) {
+            target = slot;
+            break;
+        }
+    }
+
+    //Readers that see the key also see its genome
+    __atomic_store_n(&target->key, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&target->genome, genome, __ATOMIC_RELAXED);
+    __atomic_store_n(&target->key, key, __ATOMIC_RELEASE);
+
+    flock(m_file, LOCK_UN);
+}
+
+SolutionCache::Impl::~Impl() {
+
+    if (m_mapping != MAP_FAILED) munmap(m_mapping, m_size);
+    if (m_file >= 0) close(m_file);
+}
+
+#pragma mark - SolutionCache functions
+
+SolutionCache::SolutionCache(const std::string& path, size_t capacity) :
+m_pimpl(new Impl(path, capacity))
+{ }
+
+std::string SolutionCache::Canonicalize(const std::string& query, std::string* letters) {
+
+    //Split into operands and the operators that follow them (the result has none)
+    std::vector<std::string> operands(1);
+    std::string operators;
+
+    for (char character : query) {
+
+        if (IsOperator(character)) {
+            operators.push_back(character);
+            operands.push_back(std::string());
+        }
+        else operands.back().push_back(character);
+    }
+
+    //Operations are taken one per pair, as Fitness does, so a pair is commutative by the operator of its index
+    std::vector<size_t> commutative;
+    for (size_t pair = 0 ; pair < (operands.size() - 1) / 2 && pair < operators.size() ; pair++)
+        if ((operators[pair] == '+' || operators[pair] == '*') && commutative.size() < kMaxSwappedPairs)
+            commutative.push_back(pair);
+
+    std::string best, best_letters;
+
+    for (size_t swaps = 0 ; swaps < (size_t(1) << commutative.size()) ; swaps++) {
+
+        std::vector<std::string> ordered(operands);
+        for (size_t index = 0 ; index < commutative.size() ; index++)
+            if (swaps & (size_t(1) << index))
+                std::swap(ordered[commutative[index] * 2], ordered[commutative[index] * 2 + 1]);
+
+        std::string text = ordered[0];
+        for (size_t index = 0 ; index < operators.size() ; index++)
+            text += operators[index] + ordered[index + 1];
+
+        std::string candidate_letters;
+        std::string candidate = Relabel(text, candidate_letters);
+
+        if (candidate_letters.size() > kMaxLetters) return std::string();
+
+        if (best.empty() || candidate < best) {
+            best = candidate;
+            best_letters = candidate_letters;
+        }
+    }
+
+    if (letters) *letters = best_letters;
+
+    return best;
+}
+
+bool SolutionCache::Find(const std::string& query, Chromosome& solution) const {
+    return m_pimpl->Find(query, solution);
+}
+
+void SolutionCache::Store(const std::string& query, const Chromosome& solution) {
+    m_pimpl->Store(query, solution);
+}
+
+SolutionCache::~SolutionCache() { }
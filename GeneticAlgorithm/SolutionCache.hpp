@@ -0,0 +1,86 @@
+//
+//  SolutionCache.hpp
+//  GeneticAlgorithm
+//
+//  Created by Maxim Vainshtein on 19/10/2026.
+//  Copyright © 2026 Maxim Vainshtein. All rights reserved.
+//
+
+#ifndef SolutionCache_hpp
+#define SolutionCache_hpp
+#include <stdlib.h>
+#include <cstdint>
+#include <string>
+#include <memory>
+#include "Chromosome.hpp"
+
+/**
+ * A persistent cache of solved queries, kept in a memory mapped file that can be
+ * shared by several processes.
+ *
+ * Queries are stored in a canonical form, so the same puzzle with renamed letters or
+ * with the operands of a commutative pair ('+' or '*') swapped is a single entry:
+ * the letters are relabelled A, B, C... in the order that they first appear, and of
+ * the possible orders of the commutative operands the one with the smallest relabelled
+ * text is kept. For example both
+ * "SEND+MORE=MONEY" and "MORE+SEND=MONEY" are stored as "ABCD+EDFG=ABFDH".
+ *
+ * The file is an open addressing table of (hash of canonical query, packed solution)
+ * slots. A lookup reads the mapping without locks and a store takes an exclusive
+ * flock. Since a hash collision or a torn read can return a wrong solution, a found
+ * solution should be verified by the caller (as GeneticAlgorithm does with its fitness).
+ */
+class SolutionCache {
+public:
+
+    /**
+     * Constructor.
+     * Opens the cache file, creating it if it does not exist.
+     * Throws std::runtime_error if the file cannot be opened or is not a cache file.
+     *
+     * @param path      Path of the cache file.
+     * @param capacity  Number of slots of a new file (rounded up to a power of 2).
+     */
+    SolutionCache(const std::string& path, size_t capacity = 1 << 16);
+
+    /**
+     * Returns the canonical form of the query.
+     *
+     * @param query     The query, such as "SEND+MORE=MONEY".
+     * @param letters   Receives the letters of the query in the order of their canonical labels,
+     *                  so letters[0] is labelled 'A' (can be NULL).
+     * @return          The canonical query, empty if the query has more than 16 letters.
+     */
+    static std::string Canonicalize(const std::string& query, std::string* letters = NULL);
+
+    /**
+     * Finds the stored solution of the query, in the letters of the query.
+     *
+     * @param query     The query to look up.
+     * @param solution  Receives the solution if it was found.
+     * @return          True if a solution was found.
+     */
+    bool Find(const std::string& query, Chromosome& solution) const;
+
+    /**
+     * Stores the solution of the query, replacing an earlier one.
+     *
+     * @param query     The solved query.
+     * @param solution  The solution, in the letters of the query.
+     */
+    void Store(const std::string& query, const Chromosome& solution);
+
+    /**
+     * Destructor.
+     * Unmaps the file.
+     */
+    ~SolutionCache();
+
+private:
+
+    class Impl;
+    std::unique_ptr<Impl> m_pimpl;
+
+};
+
+#endif /* SolutionCache_hpp */
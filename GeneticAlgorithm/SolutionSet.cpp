@@ -0,0 +1,71 @@
+//
+//  SolutionSet.cpp
+//  GeneticAlgorithm
+//
+//  Created by Maxim Vainshtein on 19/10/2026.
+//  Copyright © 2026 Maxim Vainshtein. All rights reserved.
+//
+
+#include "SolutionSet.hpp"
+#include <unordered_map>
+#include <mutex>
+#include <algorithm>
+
+/**
+ * A part of the set with its own lock.
+ */
+class SolutionSet::Shard {
+public:
+
+    std::mutex mutex;
+
+    ///Discovery time of every chromosome of the shard.
+    std::unordered_map<uint64_t, double> genomes;
+
+};
+
+SolutionSet::SolutionSet(size_t shards) :
+m_shards(new Shard[shards ? shards : 1]),
+m_shard_count(shards ? shards : 1),
+m_size(0),
+m_start(std::chrono::steady_clock::now())
+{ }
+
+bool SolutionSet::Insert(uint64_t genome) {
+
+    //Mix the bits, neighbouring genomes differ in a single nibble
+    uint64_t hash = genome * 0x9E3779B97F4A7C15ULL;
+    Shard& shard = m_shards[(hash >> 32) % m_shard_count];
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - m_start;
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (!shard.genomes.insert(std::make_pair(genome, elapsed.count())).second) return false;
+
+    m_size++;
+
+    return true;
+}
+
+size_t SolutionSet::Size() const {
+    return m_size.load();
+}
+
+std::vector<std::pair<uint64_t, double>> SolutionSet::Discoveries() const {
+
+    std::vector<std::pair<uint64_t, double>> discoveries;
+
+    for (size_t index = 0 ; index < m_shard_count ; index++) {
+
+        std::lock_guard<std::mutex> lock(m_shards[index].mutex);
+        discoveries.insert(discoveries.end(), m_shards[index].genomes.begin(), m_shards[index].genomes.end());
+    }
+
+    std::sort(discoveries.begin(), discoveries.end(), [](const std::pair<uint64_t, double>& lhs, const std::pair<uint64_t, double>& rhs) {
+        return lhs.second < rhs.second;
+    });
+
+    return discoveries;
+}
+
+SolutionSet::~SolutionSet() { }
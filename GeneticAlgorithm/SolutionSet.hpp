@@ -0,0 +1,76 @@
+//
+//  SolutionSet.hpp
+//  GeneticAlgorithm
+//
+//  Created by Maxim Vainshtein on 19/10/2026.
+//  Copyright © 2026 Maxim Vainshtein. All rights reserved.
+//
+
+#ifndef SolutionSet_hpp
+#define SolutionSet_hpp
+#include <stdlib.h>
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <utility>
+
+/**
+ * A set of packed chromosomes that many threads insert into at the same time. The
+ * set is split into shards by hash, each with its own lock, so concurrent inserts
+ * rarely wait for each other. Every chromosome keeps the time it was first inserted.
+ */
+class SolutionSet {
+public:
+
+    /**
+     * Constructor.
+     * The discovery times are measured from the construction.
+     *
+     * @param shards    Number of independently locked parts.
+     */
+    SolutionSet(size_t shards = 16);
+
+    /**
+     * Adds a chromosome to the set (thread safe).
+     *
+     * @param genome    The packed chromosome.
+     * @return          True if the chromosome was not in the set.
+     */
+    bool Insert(uint64_t genome);
+
+    /**
+     * Returns the number of chromosomes in the set (thread safe).
+     *
+     * @return  Number of chromosomes.
+     */
+    size_t Size() const;
+
+    /**
+     * Returns the chromosomes with the seconds from construction at which they were
+     * inserted, in the order of discovery.
+     *
+     * @return  The chromosomes and their discovery times.
+     */
+    std::vector<std::pair<uint64_t, double>> Discoveries() const;
+
+    /**
+     * Destructor.
+     */
+    ~SolutionSet();
+
+private:
+
+    class Shard;
+
+    std::unique_ptr<Shard[]> m_shards;
+    size_t m_shard_count;
+
+    std::atomic<size_t> m_size;
+
+    std::chrono::steady_clock::time_point m_start;
+
+};
+
+#endif /* SolutionSet_hpp */
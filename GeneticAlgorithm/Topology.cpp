@@ -0,0 +1,159 @@
+//
+//  Topology.cpp
+//  GeneticAlgorithm
+//
+//  Created by Maxim Vainshtein on 19/10/2026.
+//  Copyright © 2026 Maxim Vainshtein. All rights reserved.
+//
+
+#include "Topology.hpp"
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <new>
+#include <algorithm>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#ifdef HAVE_LIBNUMA
+#include <numa.h>
+#endif
+
+/**
+ * Parses a sysfs list of processors such as "0-3,8,10-11".
+ */
+static std::vector<int> ParseList(const std::string& list) {
+    
+    std::vector<int> cpus;
+    std::stringstream stream(list);
+    std::string range;
+    
+    while (std::getline(stream, range, ',')) {
+        
+        if (range.empty() || range == "\n") continue;
+        
+        size_t dash = range.find('-');
+        int first = std::stoi(range.substr(0, dash));
+        int last = (dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1));
+        
+        for (int cpu = first ; cpu <= last ; cpu++) cpus.push_back(cpu);
+    }
+    
+    return cpus;
+}
+
+namespace topology {
+
+std::vector<Node> Nodes() {
+    
+    //Only the processors that the process may run on (containers often get a subset)
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    bool has_affinity = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+    
+    auto usable = [&](int cpu) { return !has_affinity || (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)); };
+#else
+    auto usable = [](int cpu) { return true; };
+#endif
+    
+    std::vector<Node> nodes;
+    
+#ifdef HAVE_LIBNUMA
+    if (numa_available() >= 0) {
+        
+        for (int node = 0 ; node <= numa_max_node() ; node++) {
+            
+            Node current = { node, std::vector<int>() };
+            for (int cpu = 0 ; cpu < numa_num_configured_cpus() ; cpu++)
+                if (numa_node_of_cpu(cpu) == node && usable(cpu)) current.cpus.push_back(cpu);
+            
+            if (!current.cpus.empty()) nodes.push_back(current);
+        }
+    }
+#endif
+    
+    //The same layout from sysfs, node ids may have gaps
+    std::ifstream online("/sys/devices/system/node/online");
+    std::string online_list;
+    
+    if (nodes.empty() && online && std::getline(online, online_list)) {
+        
+        for (const auto node : ParseList(online_list)) {
+            
+            std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+            std::string list;
+            if (!file || !std::getline(file, list)) continue;
+            
+            Node current = { node, std::vector<int>() };
+            for (const auto cpu : ParseList(list))
+                if (usable(cpu)) current.cpus.push_back(cpu);
+            
+            if (!current.cpus.empty()) nodes.push_back(current);
+        }
+    }
+    
+    //No NUMA at all
+    if (nodes.empty()) {
+        
+        Node single = { 0, std::vector<int>() };
+        for (int cpu = 0 ; cpu < static_cast<int>(std::max(1u, std::thread::hardware_concurrency())) ; cpu++)
+            if (usable(cpu)) single.cpus.push_back(cpu);
+        
+        if (single.cpus.empty()) single.cpus.push_back(0);
+        nodes.push_back(single);
+    }
+    
+    return nodes;
+}
+
+bool PinThread(int cpu) {
+    
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    //Threads cannot be pinned (macOS only takes affinity hints)
+    return false;
+#endif
+}
+
+void* Allocate(size_t size, int node) {
+    
+#ifdef HAVE_LIBNUMA
+    if (numa_available() >= 0) {
+        
+        void* memory = numa_alloc_onnode(size, node);
+        if (!memory) throw std::bad_alloc();
+        
+        return memory;
+    }
+#endif
+    
+    //Anonymous pages are zero and are placed when first touched
+    void* memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) throw std::bad_alloc();
+    
+    return memory;
+}
+
+void Free(void* memory, size_t size) {
+    
+    if (!memory) return;
+    
+#ifdef HAVE_LIBNUMA
+    if (numa_available() >= 0) {
+        
+        numa_free(memory, size);
+        return;
+    }
+#endif
+    
+    munmap(memory, size);
+}
+
+}
@@ -0,0 +1,66 @@
+//
+//  Topology.hpp
+//  GeneticAlgorithm
+//
+//  Created by Maxim Vainshtein on 19/10/2026.
+//  Copyright © 2026 Maxim Vainshtein. All rights reserved.
+//
+
+#ifndef Topology_hpp
+#define Topology_hpp
+#include <stdlib.h>
+#include <vector>
+
+/**
+ * The NUMA layout of the machine, and the placement of threads and memory on it.
+ * Uses libnuma when built with HAVE_LIBNUMA and the kernel supports it, otherwise the
+ * layout is read from sysfs and memory is placed by the first touch (the kernel puts a
+ * page on the node of the thread that first writes to it). On machines without NUMA
+ * everything is a single node.
+ */
+namespace topology {
+
+/**
+ * A NUMA node and the processors on it that the process may run on.
+ */
+struct Node {
+    int id;
+    std::vector<int> cpus;
+};
+
+/**
+ * Returns the nodes that have processors the process may run on, in order of id.
+ * Always returns at least one node.
+ */
+std::vector<Node> Nodes();
+
+/**
+ * Pins the calling thread to a processor (on Linux).
+ *
+ * @param cpu   The processor.
+ * @return      True if pinned.
+ */
+bool PinThread(int cpu);
+
+/**
+ * Allocates zeroed memory on a node. Without libnuma the memory is mapped but not
+ * touched, so the caller should be pinned to the node and write to it first.
+ * Throws std::bad_alloc if the memory cannot be allocated.
+ *
+ * @param size  Size in bytes.
+ * @param node  The node to allocate on.
+ * @return      The memory, released by Free.
+ */
+void* Allocate(size_t size, int node);
+
+/**
+ * Releases memory from Allocate.
+ *
+ * @param memory    The memory.
+ * @param size      Size in bytes, as allocated.
+ */
+void Free(void* memory, size_t size);
+
+}
+
+#endif /* Topology_hpp */
@@ -10,6 +10,7 @@
 #include <iostream>
 #include <ctime>
 #include <algorithm>
+#include <random>
 
 using namespace utility;
 
@@ -19,8 +20,26 @@ bool utility::ThrowDice(float probability) {
     return RandomProbability() < probability;
 }
 
+/**
+ * Returns the generator of the calling thread.
+ */
+static std::minstd_rand& Generator() {
+    
+    //Seeding from std::rand keeps runs reproducible with std::srand
+    thread_local std::minstd_rand generator(std::rand());
+    return generator;
+}
+
 float utility::RandomProbability() {
-    return (double)std::rand() / RAND_MAX;
+    return std::generate_canonical<float, 24>(Generator());
+}
+
+int utility::RandomInteger(int range) {
+    return std::uniform_int_distribution<int>(0, range - 1)(Generator());
+}
+
+void utility::Seed(unsigned seed) {
+    Generator().seed(seed);
 }
 
 std::string utility::Alphabet(const std::string &input) {
@@ -21,6 +21,17 @@ bool ThrowDice(float probability);
  */
 float RandomProbability();
 
+/**
+ * Returns a random integer in the range 0...range-1. Every thread has its own
+ * generator, seeded from std::rand on first use, so threads do not contend.
+ */
+int RandomInteger(int range);
+
+/**
+ * Reseeds the generator of the calling thread, so that its draws can be repeated.
+ */
+void Seed(unsigned seed);
+
 /**
  * Returns the letters that make up the input as a set.
  */
@@ -0,0 +1,358 @@
+//
+//  WorkStealingScheduler.cpp
+//  GeneticAlgorithm
+//
+//  Created by Maxim Vainshtein on 19/10/2026.
+//  Copyright © 2026 Maxim Vainshtein. All rights reserved.
+//
+
+#include "WorkStealingScheduler.hpp"
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <exception>
+
+/**
+ * Implementation.
+ */
+class WorkStealingScheduler::Impl {
+public:
+    
+    /**
+     * Constructor.
+     *
+     * @param threads   Number of workers, 0 for all cores.
+     */
+    Impl(size_t threads);
+    
+    size_t Threads() const;
+    void ParallelFor(size_t count, size_t chunk, const task& task);
+    Statistics Totals() const;
+    void ResetTotals();
+    
+    /**
+     * Destructor.
+     */
+    ~Impl();
+    
+private:
+    
+    /**
+     * A chunk of indices.
+     */
+    struct Range {
+        size_t begin;
+        size_t end;
+    };
+    
+    /**
+     * The deque and the counters of a worker, padded so that workers do not share a cache line.
+     */
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Range> ranges;
+        
+        size_t tasks;
+        size_t steals;
+        size_t failed_steals;
+        double busy_seconds;
+        
+        char padding[64];
+    };
+    
+    /**
+     * Waits for the loops and runs their chunks, for the workers other than the caller.
+     *
+     * @param worker    Index of the worker.
+     */
+    void Helper(size_t worker);
+    
+    /**
+     * Runs chunks of the current loop until all of them are taken, or until a chunk throws.
+     *
+     * @param worker    Index of the worker.
+     */
+    void Run(size_t worker);
+    
+    /**
+     * Takes a chunk from the back of the worker's own deque.
+     */
+    bool Pop(size_t worker, Range& range);
+    
+    /**
+     * Takes a chunk from the front of another worker's deque, counts a failed steal if
+     * every other deque is empty.
+     */
+    bool Steal(size_t worker, Range& range);
+    
+    size_t m_threads;
+    std::unique_ptr<Worker[]> m_workers;
+    std::vector<std::thread> m_helpers;
+    
+    ///The task of the current loop.
+    const task* m_task;
+    
+    ///True once a chunk of the current loop threw, the rest of the chunks are dropped.
+    std::atomic<bool> m_failed;
+    
+    ///The first exception of the current loop, rethrown by ParallelFor.
+    std::exception_ptr m_error;
+    
+    ///Incremented for every loop, the helpers wait for a change.
+    size_t m_loop;
+    
+    ///Number of helpers that are done with the current loop.
+    size_t m_finished;
+    
+    bool m_stopping;
+    
+    ///Guards the loop state above.
+    std::mutex m_mutex;
+    std::condition_variable m_started;
+    std::condition_variable m_done;
+    
+    ///Idle time of the loops since the last reset.
+    double m_idle_seconds;
+    
+};
+
+#pragma mark - Implementation functions
+
+WorkStealingScheduler::Impl::Impl(size_t threads) :
+m_threads(threads ? threads : std::max(1u, std::thread::hardware_concurrency())),
+m_workers(new Worker[m_threads]),
+m_task(NULL),
+m_failed(false),
+m_loop(0),
+m_finished(0),
+m_stopping(false),
+m_idle_seconds(0)
+{
+    ResetTotals();
+    
+    for (size_t worker = 1 ; worker < m_threads ; worker++)
+        m_helpers.push_back(std::thread(&Impl::Helper, this, worker));
+}
+
+size_t WorkStealingScheduler::Impl::Threads() const { return m_threads; }
+
+void WorkStealingScheduler::Impl::ParallelFor(size_t count, size_t chunk, const task& task) {
+    
+    if (count == 0) return;
+    
+    chunk = std::max<size_t>(1, chunk);
+    size_t chunks = (count + chunk - 1) / chunk;
+    
+    //Every worker starts with a contiguous share, so neighbouring indices stay on one thread unless stolen
+    for (size_t worker = 0 ; worker < m_threads ; worker++) {
+        
+        std::lock_guard<std::mutex> lock(m_workers[worker].mutex);
+        
+        for (size_t index = chunks * worker / m_threads ; index < chunks * (worker + 1) / m_threads ; index++)
+            m_workers[worker].ranges.push_back({ index * chunk, std::min(count, (index + 1) * chunk) });
+    }
+    
+    double busy = 0;
+    for (size_t worker = 0 ; worker < m_threads ; worker++) busy += m_workers[worker].busy_seconds;
+    
+    auto start = std::chrono::steady_clock::now();
+    
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        
+        m_task = &task;
+        m_failed = false;
+        m_error = nullptr;
+        m_finished = 0;
+        m_loop++;
+    }
+    
+    m_started.notify_all();
+    
+    Run(0);
+    
+    //Every helper takes part in every loop, so none of them can still hold the task after this
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this]() { return m_finished == m_helpers.size(); });
+    
+    m_task = NULL;
+    
+    //Whatever the workers did not spend on chunks they spent waiting
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    for (size_t worker = 0 ; worker < m_threads ; worker++) busy -= m_workers[worker].busy_seconds;
+    
+    m_idle_seconds += std::max(0.0, elapsed.count() * m_threads + busy);
+    
+    if (!m_error) return;
+    
+    //The chunks that were dropped would otherwise run with the next loop
+    for (size_t worker = 0 ; worker < m_threads ; worker++) {
+        
+        std::lock_guard<std::mutex> ranges_lock(m_workers[worker].mutex);
+        m_workers[worker].ranges.clear();
+    }
+    
+    std::exception_ptr error = m_error;
+    m_error = nullptr;
+    
+    std::rethrow_exception(error);
+}
+
+void WorkStealingScheduler::Impl::Helper(size_t worker) {
+    
+    size_t seen = 0;
+    
+    while (true) {
+        
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_started.wait(lock, [&]() { return m_stopping || m_loop != seen; });
+            
+            if (m_stopping) return;
+            seen = m_loop;
+        }
+        
+        Run(worker);
+        
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_finished++;
+        }
+        
+        m_done.notify_all();
+    }
+}
+
+void WorkStealingScheduler::Impl::Run(size_t worker) {
+    
+    Worker& self = m_workers[worker];
+    
+    while (!m_failed) {
+        
+        //Chunks are only added before a loop starts, so once every deque is empty the last ones are running
+        Range range;
+        if (Pop(worker, range)) { }
+        else if (Steal(worker, range)) self.steals++;
+        else return;
+        
+        auto start = std::chrono::steady_clock::now();
+        
+        try { (*m_task)(range.begin, range.end, worker); }
+        catch (...) {
+            
+            //The first error stops the loop, ParallelFor rethrows it once every worker is done
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_error) m_error = std::current_exception();
+            
+            m_failed = true;
+        }
+        
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        
+        self.busy_seconds += elapsed.count();
+        self.tasks++;
+    }
+}
+
+bool WorkStealingScheduler::Impl::Pop(size_t worker, Range& range) {
+    
+    Worker& self = m_workers[worker];
+    std::lock_guard<std::mutex> lock(self.mutex);
+    
+    if (self.ranges.empty()) return false;
+    
+    range = self.ranges.back();
+    self.ranges.pop_back();
+    
+    return true;
+}
+
+bool WorkStealingScheduler::Impl::Steal(size_t worker, Range& range) {
+    
+    //The next workers first, so that thieves spread over the victims
+    for (size_t offset = 1 ; offset < m_threads ; offset++) {
+        
+        Worker& victim = m_workers[(worker + offset) % m_threads];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        
+        if (victim.ranges.empty()) continue;
+        
+        range = victim.ranges.front();
+        victim.ranges.pop_front();
+        
+        return true;
+    }
+    
+    m_workers[worker].failed_steals++;
+    
+    return false;
+}
+
+WorkStealingScheduler::Statistics WorkStealingScheduler::Impl::Totals() const {
+    
+    Statistics totals = { 0, 0, 0, 0, m_idle_seconds };
+    
+    for (size_t worker = 0 ; worker < m_threads ; worker++) {
+        
+        totals.tasks += m_workers[worker].tasks;
+        totals.steals += m_workers[worker].steals;
+        totals.failed_steals += m_workers[worker].failed_steals;
+        totals.busy_seconds += m_workers[worker].busy_seconds;
+    }
+    
+    return totals;
+}
+
+void WorkStealingScheduler::Impl::ResetTotals() {
+    
+    for (size_t worker = 0 ; worker < m_threads ; worker++) {
+        
+        m_workers[worker].tasks = 0;
+        m_workers[worker].steals = 0;
+        m_workers[worker].failed_steals = 0;
+        m_workers[worker].busy_seconds = 0;
+    }
+    
+    m_idle_seconds = 0;
+}
+
+WorkStealingScheduler::Impl::~Impl() {
+    
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    
+    m_started.notify_all();
+    
+    for (auto& helper : m_helpers) helper.join();
+}
+
+#pragma mark - WorkStealingScheduler functions
+
+WorkStealingScheduler::WorkStealingScheduler(size_t threads) :
+m_pimpl(new Impl(threads))
+{ }
+
+size_t WorkStealingScheduler::Threads() const {
+    return m_pimpl->Threads();
+}
+
+void WorkStealingScheduler::ParallelFor(size_t count, size_t chunk, const task& task) {
+    m_pimpl->ParallelFor(count, chunk, task);
+}
+
+WorkStealingScheduler::Statistics WorkStealingScheduler::Totals() const {
+    return m_pimpl->Totals();
+}
+
+void WorkStealingScheduler::ResetTotals() {
+    m_pimpl->ResetTotals();
+}
+
+WorkStealingScheduler::~WorkStealingScheduler() { }
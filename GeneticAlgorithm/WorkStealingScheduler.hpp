@@ -0,0 +1,104 @@
+//
+//  WorkStealingScheduler.hpp
+//  GeneticAlgorithm
+//
+//  Created by Maxim Vainshtein on 19/10/2026.
+//  Copyright © 2026 Maxim Vainshtein. All rights reserved.
+//
+
+#ifndef WorkStealingScheduler_hpp
+#define WorkStealingScheduler_hpp
+#include <stdlib.h>
+#include <functional>
+#include <memory>
+
+/**
+ * Runs loops over index ranges on a fixed set of threads, for work whose cost varies a
+ * lot between indices. The range is cut into small chunks and every worker starts with
+ * a contiguous share of them in its own deque. A worker takes chunks from the back of
+ * its deque, and once it is empty steals from the front of the others, so a worker that
+ * got expensive chunks is helped instead of leaving the rest idle. A worker that finds
+ * every deque empty waits for the loop to end without spinning.
+ */
+class WorkStealingScheduler {
+public:
+    
+    /**
+     * Receives a chunk [begin, end) and the index of the worker that runs it.
+     */
+    typedef std::function<void(size_t begin, size_t end, size_t worker)> task;
+    
+    /**
+     * Totals of the loops since construction (or the last reset).
+     */
+    struct Statistics {
+        
+        ///Number of chunks that were run.
+        size_t tasks;
+        
+        ///Number of chunks that were taken from another worker.
+        size_t steals;
+        
+        ///Number of times a worker found every other deque empty (at most once per worker per loop).
+        size_t failed_steals;
+        
+        ///Time that the workers spent running chunks, summed over the workers.
+        double busy_seconds;
+        
+        ///Time that the workers spent without a chunk while a loop was running, summed over the workers.
+        double idle_seconds;
+    };
+    
+    /**
+     * Constructor.
+     * Starts the threads, the thread that calls ParallelFor is one of the workers.
+     *
+     * @param threads   Number of workers (0 for all cores).
+     */
+    WorkStealingScheduler(size_t threads);
+    
+    /**
+     * Returns the number of workers.
+     *
+     * @return  Number of workers.
+     */
+    size_t Threads() const;
+    
+    /**
+     * Runs the task over the chunks of [0, count) and returns once all of them are done.
+     * Must not be called concurrently or from a task. If a chunk throws, the chunks that
+     * did not start are dropped and the first exception is rethrown once every worker is
+     * done with the loop.
+     *
+     * @param count     Number of indices.
+     * @param chunk     Number of indices per chunk.
+     * @param task      The task to run for every chunk.
+     */
+    void ParallelFor(size_t count, size_t chunk, const task& task);
+    
+    /**
+     * Returns the totals of the loops.
+     *
+     * @return  The totals.
+     */
+    Statistics Totals() const;
+    
+    /**
+     * Resets the totals.
+     */
+    void ResetTotals();
+    
+    /**
+     * Destructor.
+     * Stops and joins the threads.
+     */
+    ~WorkStealingScheduler();
+    
+private:
+    
+    class Impl;
+    std::unique_ptr<Impl> m_pimpl;
+    
+};
+
+#endif /* WorkStealingScheduler_hpp */
@@ -9,8 +9,13 @@
 #include "GeneticAlgorithm.hpp"
 #include "Fitness.hpp"
 #include "Chromosome.hpp"
+#include "Server.hpp"
+#include "Portfolio.hpp"
+#include "Configuration.hpp"
 #include <iostream>
 #include <ctime>
+#include <chrono>
+#include <stdexcept>
 
 int main(int argc, const char * argv[]) {
 
@@ -23,19 +28,129 @@ int main(int argc, const char * argv[]) {
         << "Number of chromosomes (populations).\n"
         << "Crossover probability (with range of 0...1).\n"
         << "Mutation probability (with range of 0...1).\n"
-        << "Type of fitness function: 1 = Edit Distance. 2 = Closeness.\n"
-        << "Number of generations (0 for no limit)."
+        << "Type of fitness function: 1 = Edit Distance. 2 = Closeness. 3 = Column carry (additions and subtractions).\n"
+        << "Number of generations (0 for no limit).\n"
+        << "Stagnation window in generations before a partial restart (optional, 0 to disable).\n"
+        << "Mode: 1 = Generational. 2 = Steady state. 3 = Islands, one per core placed on the NUMA nodes (optional).\n"
+        << "Offspring pipeline depth in batches (optional, 0 to disable).\n"
+        << "Distinct digits: 1 to require a different digit per letter (optional).\n"
+        << "Code generation: 1 to compile a scoring function for the query (optional).\n"
+        << "Solution cache file, shared between runs (optional).\n"
+        << "Find all solutions: number of seconds to search for (optional, 0 to find one).\n"
+        << "Time budget in milliseconds, printing the best score whenever it improves (optional, 0 for no limit).\n"
+        << "Population file, to keep a generational population larger than the memory on disk (optional).\n"
+        << "Pre-filter: 0 = None. 1 = Exact (default). 2 = Penalise chromosomes that fail the units column or the magnitude (optional).\n"
+        << "Or use a configuration file (see autotune): --config <file> <expression> [generations] [distinct digits].\n"
+        << "Or race several configurations: --portfolio <expression> [generations] [threads] [winners file] [distinct digits].\n"
+        << "Or run as a server: --serve <socket path> [number of workers] [code generation] (see genetic-client)."
         << std::endl;
         return 0;
     }
     
+    //Serve requests over a Unix domain socket until killed
+    if (std::string(argv[1]) == "--serve" && argc > 2) {
+        
+        std::srand((unsigned)std::time(0));
+        
+        Server server(argv[2], (argc > 3) ? std::stoi(argv[3]) : 4, (argc > 4) && std::stoi(argv[4]) != 0);
+        
+        try { server.Run(); }
+        catch (const std::runtime_error& error) {
+            
+            std::cerr << error.what() << std::endl;
+            return 1;
+        }
+        
+        return 0;
+    }
+    
+    
+    //The parameters of the shape of the query from a file, the defaults of the file otherwise
+    if (std::string(argv[1]) == "--config" && argc > 3) {
+        
+        std::srand((unsigned)std::time(0));
+        
+        Configuration configuration = { 200, 1, 0.1f, Fitness::kEditDistance };
+        bool loaded = false;
+        
+        try { loaded = Configuration::Load(argv[2], Configuration::Shape(argv[3]), configuration); }
+        catch (const std::runtime_error& error) { std::cerr << error.what() << '\n'; }
+        
+        if (!loaded) {
+            
+            std::cerr << "Cannot read a configuration from " << argv[2] << std::endl;
+            return 1;
+        }
+        
+        std::cout << "Configuration: " << configuration << '\n';
+        
+        GeneticAlgorithm algorithm(configuration.population, configuration.crossover, configuration.mutation);
+        if (argc > 5) algorithm.SetDistinctDigits(std::stoi(argv[5]) != 0);
+        
+        std::cout << algorithm.FindSolution(argv[3], configuration.type, (argc > 4) ? std::stoi(argv[4]) : 0) << std::endl;
+        
+        return 0;
+    }
+    
+    //Race the default configurations, the winner of the shape of the query first
+    if (std::string(argv[1]) == "--portfolio" && argc > 2) {
+        
+        std::srand((unsigned)std::time(0));
+        
+        Portfolio portfolio(Portfolio::DefaultConfigurations(), (argc > 4) ? std::stoi(argv[4]) : 0);
+        if (argc > 5) portfolio.SetWinnerFile(argv[5]);
+        if (argc > 6) portfolio.SetDistinctDigits(std::stoi(argv[6]) != 0);
+        
+        std::cout << portfolio.Solve(argv[2], (argc > 3) ? std::stoi(argv[3]) : 0) << std::endl;
+        
+        return 0;
+    }
     
     //Use current time as seed for random generator
     std::srand((unsigned)std::time(0));
     
-    GeneticAlgorithm algorithm(std::stoi(argv[2]), std::stof(argv[3]), std::stof(argv[4]));
-    
-    std::cout << algorithm.FindSolution(argv[1], static_cast<Fitness::Type>(std::stoi(argv[5])), std::stoi(argv[6])) << std::endl;
+    try {
+        
+        GeneticAlgorithm algorithm(std::stoi(argv[2]), std::stof(argv[3]), std::stof(argv[4]), (argc > 9) ? std::stoi(argv[9]) : 0);
+        
+        if (argc > 7) algorithm.SetStagnation(std::stoi(argv[7]));
+        if (argc > 8) algorithm.SetMode(static_cast<GeneticAlgorithm::Mode>(std::stoi(argv[8])));
+        if (argc > 10) algorithm.SetDistinctDigits(std::stoi(argv[10]) != 0);
+        if (argc > 11) algorithm.SetCodeGeneration(std::stoi(argv[11]) != 0);
+        if (argc > 12) algorithm.SetSolutionCache(argv[12]);
+        if (argc > 15) algorithm.SetPopulationFile(argv[15]);
+        if (argc > 16) algorithm.SetPreFilter(static_cast<Fitness::Filter>(std::stoi(argv[16])));
+        
+        //The best answer within the time, with the improvements on the way
+        if (argc > 14 && std::stod(argv[14]) > 0) {
+            
+            auto start = std::chrono::steady_clock::now();
+            
+            algorithm.SetTimeBudget(std::stod(argv[14]) / 1000);
+            algorithm.SetProgressCallback([start](const Chromosome& chromosome, size_t score) {
+                
+                std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+                std::cout << "Best score " << score << " after " << elapsed.count() << " ms\n";
+            });
+        }
+        
+        //Every solution found within the time
+        if (argc > 13 && std::stod(argv[13]) > 0) {
+            
+            for (const auto& solution : algorithm.FindAllSolutions(argv[1], static_cast<Fitness::Type>(std::stoi(argv[5])), std::stoi(argv[6]), 0, std::stod(argv[13])))
+                std::cout << solution << std::endl;
+            
+            return 0;
+        }
+        
+        std::cout << algorithm.FindSolution(argv[1], static_cast<Fitness::Type>(std::stoi(argv[5])), std::stoi(argv[6])) << std::endl;
+    }
+    catch (const std::exception& error) {
+        
+        //Such as a solution cache that cannot be opened or a population file that already exists
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
 
     return 0;
 }